@@ -0,0 +1,223 @@
+/*
+ *  minikernel/include/datos_llamsis.h
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero de cabecera que contiene los tipos y constantes que intercambian
+ * el ncleo y la biblioteca a travs de las llamadas al sistema. Lo
+ * incluyen kernel.h y servicios.h, por lo que ambos ven siempre la misma
+ * definicin.
+ *
+ *	SE DEBE MODIFICAR AL INCLUIR LLAMADAS QUE DEVUELVAN ESTRUCTURAS
+ *
+ */
+
+#ifndef _DATOS_LLAMSIS_H
+#define _DATOS_LLAMSIS_H
+
+/*
+*
+* Definicin del tipo struct tiempos_ejec
+*
+*/
+struct tiempos_ejec {
+	int usuario;
+	int sistema;
+};
+
+/*
+*
+* Definicin del tipo struct pagina_info: pgina de informacin del
+* ncleo, al estilo del vDSO, que cada proceso lee sin hacer llamadas.
+* El ncleo deja secuencia impar mientras la modifica; una lectura es
+* coherente si secuencia era par y no cambi durante la copia.
+*
+*/
+struct pagina_info {
+	unsigned int secuencia;		/* contador de modificaciones */
+	int id;				/* identificador del proceso */
+	unsigned long long ticks;	/* ticks desde el arranque (64 bits) */
+	unsigned long long reloj_base;	/* reloj CMOS en el arranque */
+	int ticks_por_seg;		/* frecuencia del reloj */
+	int usuario;			/* ticks del proceso en modo usuario */
+	int sistema;			/* ticks del proceso en modo sistema */
+};
+
+/*
+ * Estadisticas del sistema que devuelve obtener_estadisticas. Si se
+ * cambia la estructura hay que incrementar VERSION_ESTADISTICAS, y los
+ * campos nuevos se anaden siempre al final.
+ */
+#define VERSION_ESTADISTICAS 3
+
+#define FIJO_1 2048		/* 1.0 en la coma fija de las cargas medias */
+
+/* motivos de cambio de contexto */
+#define CAMBIO_BLOQUEO 0	/* en un objeto de sincronizacion o IPC */
+#define CAMBIO_DORMIR 1
+#define CAMBIO_MUTEX 2
+#define CAMBIO_FIN 3
+#define CAMBIO_OCIOSO 4		/* del proceso ocioso a uno listo */
+#define NUM_MOTIVOS_CAMBIO 5
+
+/* uso de una cache del asignador de objetos del nucleo */
+#define MAX_CACHES 8
+#define MAX_NOM_CACHE 15
+
+struct uso_cache {
+	char nombre[MAX_NOM_CACHE+1];
+	int tam_objeto;
+	int slabs;
+	int objetos;		/* construidos, libres o en uso */
+	int en_uso;
+	int max_en_uso;
+	int fallos;		/* reservas sin memoria en la arena */
+};
+
+struct estadisticas {
+	int version;
+	int ticks_usuario;
+	int ticks_sistema;
+	int ticks_ocioso;
+	int num_listos;		/* incluido el proceso en ejecucion */
+	int num_dormidos;
+	int carga[3];		/* media de listos en 1, 5 y 15 minutos */
+	int cambios[NUM_MOTIVOS_CAMBIO];
+	int llamadas;
+	int procesos_creados;	/* incluidos los hilos */
+	int procesos_terminados;
+	int mutex_usados;
+	int procesos_en_mutex;	/* bloqueados en lock o en crear_mutex */
+	int num_caches;		/* desde la version 2 */
+	struct uso_cache caches[MAX_CACHES];
+};
+
+/*
+ * Estados de proceso que devuelve listar_procesos. LISTO y BLOQUEADO
+ * tienen el mismo valor que en const.h.
+ */
+#define LISTO 1
+#define BLOQUEADO 3
+
+/*
+ * Estado de un hilo o proceso terminado cuyo valor de salida aun no se
+ * ha recogido. Sigue ocupando su BCP, por lo que un padre que continue
+ * ejecutando debe esperar a sus hijos; los de un padre que termina se
+ * descartan.
+ */
+#define ZOMBI 4
+
+/*
+ * Colas en las que puede estar bloqueado un proceso, tal como las
+ * devuelve listar_procesos
+ */
+#define BLOQ_NINGUNO 0
+#define BLOQ_DORMIR 1
+#define BLOQ_CREAR_MUTEX 2	/* sin mutex libres en crear_mutex */
+#define BLOQ_LOCK 3
+#define BLOQ_SEM 4
+#define BLOQ_COND 5
+#define BLOQ_RW 6
+#define BLOQ_COLA_ENVIAR 7	/* cola llena */
+#define BLOQ_COLA_RECIBIR 8	/* cola vacia */
+#define BLOQ_ESPERA 9		/* esperar_hilo o esperar_proceso */
+
+/*
+*	Tipos de objeto a los que puede hacer referencia un descriptor
+*/
+#define OBJ_MUTEX 0
+#define OBJ_SEM 1
+#define OBJ_COND 2
+#define OBJ_RW 3
+#define OBJ_MEM 4
+#define OBJ_COLA 5
+
+/*
+ * Descriptor abierto de un proceso, tal como lo devuelve
+ * listar_procesos
+ */
+struct info_descriptor {
+	int desc;		/* descriptor que ve el proceso */
+	int tipo;		/* OBJ_... */
+};
+
+/*
+ * Entrada de la foto de la tabla de procesos que devuelve
+ * listar_procesos
+ */
+struct info_proceso {
+	int id;
+	int estado;
+	int padre;
+	int es_hilo;
+	int usuario;		/* ticks en modo usuario */
+	int sistema;		/* ticks en modo sistema */
+	int dormir;		/* ticks que le quedan dormido */
+	int primer_desc;	/* sus descriptores abiertos, en el vector
+				   aparte de listar_procesos */
+	int num_desc;		/* cuantos de ellos caben en ese vector */
+	int bloqueo;		/* BLOQ_... si esta BLOQUEADO */
+	int objeto;		/* descriptor del objeto o id del proceso por
+				   el que espera; -1 si la cola es global */
+	int paginas;		/* paginas de la imagen */
+	int residentes;		/* paginas de la imagen cargadas */
+};
+
+/*
+ * Contadores de contencion de un mutex. Los tiempos van en ticks.
+ */
+struct contencion_mutex {
+	int adquisiciones;
+	int contendidas;	/* adquisiciones que tuvieron que esperar */
+	int espera_total;
+	int espera_max;
+	int retencion_total;	/* desde que se adquiere hasta que se libera */
+	int retencion_max;
+	int profundidad_max;	/* maximo de bloqueos anidados */
+};
+
+/*
+ * Entrada que devuelve listar_mutex por cada mutex con nombre. MAX_NOM_MUT
+ * tiene el mismo valor que en const.h.
+ */
+#define MAX_NOM_MUT 8
+
+struct info_mutex {
+	char nombre[MAX_NOM_MUT+1];
+	int id;
+	struct contencion_mutex contencion;
+};
+
+/*
+ * Resultado de obtener_latencias: los sitios que enmascaran las
+ * interrupciones con mayor maximo y el histograma de duraciones, en el
+ * que la cubeta i cuenta las secciones de menos de 2^i microsegundos.
+ */
+#define NUM_PUESTOS_LATENCIA 8
+#define NUM_CUBETAS_LATENCIA 16
+#define MAX_NOM_SITIO 23
+
+struct sitio_latencia {
+	char funcion[MAX_NOM_SITIO+1];
+	int linea;
+	int veces;
+	long long max_ns;
+	long long total_ns;
+};
+
+struct latencias {
+	int secciones;		/* secciones medidas */
+	int sitios;		/* sitios distintos */
+	int sitios_perdidos;	/* secciones de sitios que no cabian */
+	int num_puestos;
+	struct sitio_latencia puestos[NUM_PUESTOS_LATENCIA];
+	int histograma[NUM_CUBETAS_LATENCIA];
+};
+
+#endif /* _DATOS_LLAMSIS_H */
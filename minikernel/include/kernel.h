@@ -21,16 +21,41 @@
 #include "const.h"
 #include "HAL.h"
 #include "llamsis.h"
+#include "datos_llamsis.h"
 
 
+/*
+*	Tabla de descriptores de cada proceso. Su tamano, num_desc_proc, se
+*	fija en el arranque a partir de la variable de entorno
+*	MINIKERNEL_DESCRIPTORES (DESC_PROC_DEFECTO si no esta) y como mucho
+*	vale MAX_DESC_PROC. Las entradas ocupadas se marcan en un mapa de
+*	bits de varias palabras. El descriptor que ve el usuario lleva en
+*	los bits bajos la posicion en la tabla y en los altos la generacion
+*	de la entrada, que cambia al cerrarla para invalidar descriptores
+*	viejos.
+*/
+#define BITS_DESC 10
+#define MAX_DESC_PROC (1 << BITS_DESC)
+#define MASCARA_DESC (MAX_DESC_PROC - 1)
+#define MASCARA_GENERACION 0xFFFFF
+#define DESC_PROC_DEFECTO 32
+
+#define BITS_PALABRA (8*(int)sizeof(unsigned int))
+#define PALABRAS_MAPA(n) (((n)+BITS_PALABRA-1)/BITS_PALABRA)
+
 /*
 *	Definicion del tipo para los descriptores de proceso
 */
 typedef struct {
-	int descript;
-	int libre;	
+	int descript;	/* indice del objeto en su tabla */
+	int tipo;	/* OBJ_MUTEX|OBJ_SEM|OBJ_COND|OBJ_RW|OBJ_MEM|OBJ_COLA */
+	unsigned int generacion;
+	int lecturas;	/* veces que tiene concedido como lector el
+			   cerrojo de lectores/escritores */
 } tipo_descriptor;
 
+int num_desc_proc;		/* entradas de la tabla de cada proceso */
+
 
 /*
  *
@@ -40,9 +65,73 @@ typedef struct {
  */
 typedef struct BCP_t *BCPptr;
 
+/*
+ *
+ * Definicion del tipo que corresponde con la cabecera de una lista
+ * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
+ * procesos bloqueados en semforo, etc.).
+ *
+ */
+
+typedef struct{
+	BCPptr primero;
+	BCPptr ultimo;
+} lista_BCPs;
+
+/*
+ * Imagen de memoria compartida por todos los hilos de un proceso. Se
+ * libera cuando termina el ultimo hilo que la usa.
+ */
+#define MAX_NOM_PROG 32		/* longitud maxima guardada del programa */
+
+typedef struct {
+	void *info_mem;		/* descriptor del mapa de memoria */
+	int num_hilos;		/* BCPs que usan la imagen */
+	char prog[MAX_NOM_PROG+1];	/* ejecutable del que se cargo */
+	unsigned long base_carga;	/* desplazamiento de carga; 0 si no
+					   se conoce */
+} tipo_imagen;
+
+/*
+ * Carga de las imagenes. El ejecutable queda proyectado desde su fichero
+ * y, con CARGA_BAJO_DEMANDA, cada pagina se trae la primera vez que se
+ * toca: el fallo de una pagina de un segmento valido lo resuelve la
+ * proyeccion y el proceso continua, por lo que a exc_mem solo llegan
+ * los accesos invalidos. Con 0 se cargan todas al crear el proceso.
+ */
+#define CARGA_BAJO_DEMANDA 1
+
+#define PAGINAS_MINCORE 64	/* paginas que se consultan de cada vez */
+
+/* datos para recorrer los segmentos de una imagen */
+struct recorrido_imagen {
+	unsigned long base;	/* imagen buscada */
+	int precargar;		/* tocar todas sus paginas */
+	int paginas;		/* paginas de sus segmentos */
+	int residentes;		/* de ellas, las cargadas en memoria */
+};
+
+tipo_imagen imagenes[MAX_PROC];
+
+/*
+ * Recursos de procesos terminados pendientes de liberar. Se liberan
+ * cuando el procesador queda ocioso para no alargar el cambio de
+ * contexto de fin de proceso; si se acumulan MAX_PENDIENTES se liberan
+ * en el momento.
+ */
+#define MAX_PENDIENTES 4
+
+typedef struct {
+	void *info_mem;		/* mapa a liberar; NULL si sigue en uso */
+	void *pila;		/* pila a liberar */
+} tipo_pendiente;
+
+tipo_pendiente pendientes[MAX_PENDIENTES];
+int num_pendientes=0;
+
 typedef struct BCP_t {
         int id;				/* ident. del proceso */
-        int estado;			/* TERMINADO|LISTO|EJECUCION|BLOQUEADO*/
+        int estado;			/* TERMINADO|LISTO|EJECUCION|BLOQUEADO|ZOMBI*/
         contexto_t contexto_regs;	/* copia de regs. de UCP */
         void * pila;			/* dir. inicial de la pila */
 	BCPptr siguiente;		/* puntero a otro BCP */
@@ -52,41 +141,137 @@ typedef struct BCP_t {
 							 cambio de contexto involuntario */
 	int sistema;			/* Indica el numero de ticks que proc ejecuta en modo sistema*/
 	int usuario;			/* Indica el numero de ticks que proc ejecuta en modo usuario*/
-	tipo_descriptor descriptores[NUM_MUT_PROC];
+	tipo_descriptor *descriptores;	/* num_desc_proc entradas */
+	unsigned int *mapa_descriptores; /* bit n a 1 si descriptores[n]
+					   ocupado */
+	int modo_rw;			/* RW_LECTURA|RW_ESCRITURA mientras espera
+					   en un cerrojo de lectores/escritores */
+	char *buf_ipc;			/* mensaje pendiente mientras espera en una cola */
+	int long_ipc;			/* longitud de dicho mensaje */
+	tipo_imagen *imagen;		/* imagen compartida con los demas hilos */
+	int es_hilo;			/* creado con crear_hilo */
+	void *funcion_hilo;		/* funcion que ejecuta el hilo o
+					   main del proceso */
+	void *arg_hilo;			/* argumento de dicha funcion */
+	int valor_salida;		/* valor devuelto por el hilo o estado de
+					   salida del proceso al terminar */
+	lista_BCPs esperando_fin;	/* bloqueado en esperar_hilo o
+					   esperar_proceso */
+	int padre;			/* id del proceso creador; -1 si ya no
+					   existe o si es un hilo */
+	unsigned int *perfil;		/* histograma de perfilado; NULL si
+					   el perfilado esta desactivado */
+	int tam_perfil;			/* numero de celdas del histograma */
+	int escala_perfil;		/* bytes de codigo por celda */
+	lista_BCPs *lista_bloqueo;	/* lista en la que esta BLOQUEADO */
+	int plazo;			/* ticks que quedan de una espera con
+					   plazo (lock_timeout); 0 si no hay */
+	int plazo_vencido;		/* la espera termino por el plazo */
+	int mutex_cedido;		/* recibio el mutex por cesion */
+	long args[MAX_ARGS_LLAMADA];	/* argumentos de la llamada en curso */
 
 } BCP;
 
 
+
 /*
- *
- * Definicion del tipo que corresponde con la cabecera de una lista
- * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
- * procesos bloqueados en semforo, etc.).
- *
+* Nivel de interrupcin al que hay que subir para acceder a cada grupo
+* de datos: el de la interrupcin de mayor nivel que los modifica. Cada
+* sitio guarda el nivel previo en una variable local, de modo que las
+* secciones anidadas o que atraviesan un cambio de contexto no se pisan.
+* Las listas de procesos solo las toca la parte diferida del reloj, que
+* ejecuta a NIVEL_1, por lo que reloj y terminal siguen habilitados; el
+* cambio de contexto y los datos que actualiza int_reloj (tiempos de los
+* procesos, estadsticas, trabajo diferido pendiente) lo enmascaran todo.
+*
+* Esto se apoya en que la HAL solo entrega una interrupcin de nivel
+* mayor que el actual y trata cada una a su propio nivel: a NIVEL_1 no
+* entra la interrupcin software, pero s el terminal y el reloj. De ah
+* el invariante para la cola de listos, la de dormidos, las de bloqueo
+* de los objetos, lista_de_mutex, esperando_fin, el estado BLOQUEADO y
+* los plazos:
+*	- los tratan el contexto de proceso (llamadas y excepciones) y el
+*	  proceso ocioso, siempre con el nivel subido al menos a
+*	  NIVEL_LISTAS, y las rutinas diferidas, que ya ejecutan a NIVEL_1;
+*	- nunca los tocan int_reloj ni int_terminal, que pueden llegar en
+*	  mitad de cualquiera de esas secciones.
+* Un proceso se marca BLOQUEADO ya con el nivel subido, para que una
+* rutina diferida no lo vea bloqueado mientras sigue en la cola de
+* listos.
+*/
+#define NIVEL_LISTAS NIVEL_1
+#define NIVEL_RELOJ NIVEL_3
+#define NIVEL_CAMBIO NIVEL_3
+
+/*
+ * Asignador de objetos del nucleo (slab). Cada tipo de objeto tiene su
+ * cache, que obtiene de una arena estatica trozos (slabs) de TAM_SLAB
+ * bytes y los divide en objetos. Los objetos libres se guardan ya
+ * construidos en una lista, por lo que reservar y liberar cuesta un
+ * tiempo constante; solo al agotarse la lista se toma un slab nuevo.
  */
+#define TAM_SLAB 4096
+#define NUM_SLABS 16		/* tamano de la arena en slabs */
 
-typedef struct{
-	BCP *primero;
-	BCP *ultimo;
-} lista_BCPs;
+/*
+ * Enlace de la lista de objetos libres. Se guarda detras de cada objeto
+ * para no destruir su estado construido.
+ */
+typedef struct enlace_slab {
+	struct enlace_slab *siguiente;
+} enlace_slab;
 
+typedef struct {
+	struct uso_cache uso;
+	int tam_hueco;			/* objeto alineado mas su enlace */
+	void (*constructor)(void *objeto);
+	enlace_slab *libres;
+} tipo_cache;
 
-/*
-*
-* Definicin del tipo struct tiempos_ejec
-*
-*/
-struct tiempos_ejec {
-	int usuario;
-	int sistema;
-};
+void *arena_slab[NUM_SLABS][TAM_SLAB/sizeof(void *)];
+int slabs_usados;
 
+tipo_cache caches[MAX_CACHES];
+int num_caches;
+
+/* factores de decaimiento por segundo para 1, 5 y 15 minutos */
+#define EXP_1 2014		/* FIJO_1*exp(-1/60) */
+#define EXP_5 2041		/* FIJO_1*exp(-1/300) */
+#define EXP_15 2046		/* FIJO_1*exp(-1/900) */
 
 /*
-* Variable global que indica el nivel previo de interrupcin ante 
-* un cambio en el nivel de interrupcion
-*/
-int nivel_previo;
+ * Variable global con las estadisticas. Los contadores se actualizan
+ * al producirse cada evento; el resto se calcula al consultarlas.
+ */
+struct estadisticas estadisticas;
+
+/*
+ * Medida de las secciones con las interrupciones enmascaradas (desde que
+ * se sube a NIVEL_3 hasta que se baja). Se agrupan por el sitio que sube
+ * el nivel; obtener_latencias devuelve los sitios con mayor maximo y un
+ * histograma en el que la cubeta i cuenta las secciones de menos de 2^i
+ * microsegundos (y al menos 2^(i-1)); la ultima recoge las demas.
+ */
+#define MAX_SITIOS_LATENCIA 48
+
+typedef struct {
+	const char *funcion;	/* se compara por direccion */
+	int linea;
+	int veces;
+	long long max_ns;
+	long long total_ns;
+} tipo_sitio;
+
+tipo_sitio sitios_latencia[MAX_SITIOS_LATENCIA];
+struct latencias latencias;
+
+/* seccion en curso */
+struct seccion_enmascarada {
+	int abierta;
+	const char *funcion;
+	int linea;
+	long long inicio;
+} enmascarado;
 
 /*
 * Variable global que indica el numero de interrupciones de reloj 
@@ -94,6 +279,17 @@ int nivel_previo;
 */
 int num_ints_desde_arranque;
 
+/*
+* Pginas de informacin, una por entrada de la tabla de procesos. La
+* misma memoria se proyecta dos veces: el ncleo escribe en
+* paginas_info y a los procesos se les entrega la direccin de su
+* pgina en paginas_info_usuario, proyectada solo para lectura.
+*/
+struct pagina_info *paginas_info;
+const struct pagina_info *paginas_info_usuario;
+unsigned long long ticks_arranque = 0;	/* cuenta de 64 bits */
+unsigned long long reloj_arranque;	/* leer_reloj_CMOS al arrancar */
+
 /*
 * Variable global que indica que se esta accediendo en modo sistema
 * a la zona donde referencia esta variable
@@ -108,21 +304,95 @@ int accede = 0;
 BCP * p_proc_actual=NULL;
 
 /*
- * Variable global que representa la tabla de procesos
+ * Variable global que representa la tabla de procesos. A diferencia de
+ * los objetos de sincronizacion, los BCPs no se reservan de una cache:
+ * el identificador de un proceso es su posicion en esta tabla, y por
+ * posicion se buscan en esperar_proceso, listar_procesos y las colas de
+ * espera; cada entrada tiene ademas su pagina de informacion y su tabla
+ * de descriptores, reservadas en el arranque. Un ZOMBI conserva su
+ * entrada y las muestras de perfilado guardan punteros a BCPs que se
+ * comprueban por su estado, lo que exige que no se reutilicen para otra
+ * cosa.
  */
 
 BCP tabla_procs[MAX_PROC];
 
+/*
+ * Variable global que representa el proceso ocioso. No esta en la tabla
+ * de procesos ni en la cola de listos; sus ticks se cuentan en sistema.
+ */
+#define ID_OCIOSO -1
+
+BCP bcp_ocioso;
+
+/*
+ * Trabajos en segundo plano que ejecuta el proceso ocioso
+ */
+#define MAX_TRABAJOS_OCIOSO 4
+
+typedef void (*trabajo_ocioso)();
+
+trabajo_ocioso trabajos_ocioso[MAX_TRABAJOS_OCIOSO];
+int num_trabajos_ocioso=0;
+
+/*
+ * Interrupciones software diferidas. Las rutinas de interrupcion hacen
+ * lo imprescindible a su nivel, marcan su bit en sirq_pendientes y
+ * activan la interrupcion software, cuyo tratamiento ejecuta la rutina
+ * diferida asociada a NIVEL_1, con el reloj y el terminal habilitados.
+ * Por ello las partes urgentes no deben tocar las listas de procesos.
+ */
+#define SIRQ_RELOJ 0
+#define SIRQ_PERFIL 1
+#define NUM_SIRQ 2
+
+typedef void (*rutina_sirq)();
+
+rutina_sirq tabla_sirq[NUM_SIRQ];
+unsigned int sirq_pendientes = 0;
+
+int ticks_diferidos = 0;	/* ticks aun no tratados por la parte diferida */
+int ticks_tratados = 0;		/* ticks tratados por la parte diferida */
+
+/*
+ * Marcos de pila que se examinan al buscar el contador de programa
+ * interrumpido durante el perfilado
+ */
+#define MAX_MARCOS_PERFIL 32
+
 /*
  * Variable global que representa la cola de procesos listos
  */
 lista_BCPs lista_listos= {NULL, NULL};
 
+/*
+ * Muestras de perfilado pendientes. La interrupcion de reloj solo
+ * guarda los marcos de pila sin resolver; la parte diferida SIRQ_PERFIL
+ * busca con dladdr el del programa y lo anota en el histograma. Si se
+ * llena antes de tratarse, las muestras nuevas se descartan.
+ */
+#define MAX_MUESTRAS_PERFIL 8
+
+struct muestra_perfil {
+	BCP *proc;		/* proceso interrumpido */
+	int num_marcos;
+	void *marcos[MAX_MARCOS_PERFIL];
+};
+
+struct muestra_perfil muestras_perfil[MAX_MUESTRAS_PERFIL];
+int num_muestras_perfil = 0;
+
 /*
 * Variable gloal que representa la lista de procesos dormidos
 */
 lista_BCPs dormidos = {NULL, NULL};
 
+/*
+* Variable global con el numero de procesos bloqueados con plazo, para
+* que la interrupcion de reloj solo los busque cuando hay alguno
+*/
+int num_con_plazo = 0;
+
 /*
 * Variable global que representa la lista de procesos en cola bloqueados
 * al crear el mutex
@@ -130,10 +400,9 @@ lista_BCPs dormidos = {NULL, NULL};
 lista_BCPs lista_de_mutex = {NULL, NULL};
 
 /*
-* Variable global que representa la lista de procesos en cola bloqueados
-* en estado lock y unlock
+* Procesos despertados de lista_de_mutex que aun no han ocupado su hueco
 */
-lista_BCPs lista_de_bloqueados = {NULL, NULL};
+int creadores_despertados = 0;
 
 /*
  *
@@ -143,6 +412,7 @@ lista_BCPs lista_de_bloqueados = {NULL, NULL};
  */
 typedef struct{
 	int (*fservicio)();
+	int nargs;		/* registros que lee tratar_llamsis */
 } servicio;
 
 
@@ -151,6 +421,14 @@ typedef struct{
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 
+/*
+ * Modos de entrega del mutex al liberarlo
+ */
+#define MODO_COMPETENCIA 0	/* se despierta a un proceso que vuelve a
+				   competir por el; otro puede adelantarse */
+#define MODO_CESION 1		/* se cede directamente al primero que
+				   espera, que pasa a ejecutar */
+
 typedef struct {
 	int propietario;	//Muestra que proceso es dueno del mutex
 	int num_procs_en_mutex;	// Indica numero de procesos en el mutex
@@ -159,10 +437,136 @@ typedef struct {
 					*  = 0 -> Indica que el mutex esta libre
 					*  Negativo -> Indica un error
 					*/
-	char*nombre_mutex;
+	struct contencion_mutex contencion;
+	int inicio_retencion;	// Tick en que se adquirio
+	int modo;		// MODO_COMPETENCIA o MODO_CESION
+	lista_BCPs bloqueados;	// Procesos esperando en lock
 } tipo_mutex;
 
-tipo_mutex mutex[NUM_MUT];
+/*
+ * Los mutex se reservan de cache_mutex al crearlos; las entradas sin
+ * mutex valen NULL. La tabla empieza con NUM_MUT entradas y crece de
+ * TROZO_MUT en TROZO_MUT hasta MAX_MUT; solo al llegar a este limite
+ * se bloquea crear_mutex.
+ */
+#define MAX_MUT 64
+#define TROZO_MUT 16
+
+tipo_mutex *mutex[MAX_MUT];
+int num_mut = NUM_MUT;		/* entradas de la tabla en uso */
+tipo_cache *cache_mutex;
+
+
+// Especificacion de SEMAFOROS y VARIABLES CONDICION
+
+/*
+ * Como los mutex, los semaforos, variables condicion, cerrojos de
+ * lectores/escritores y colas se reservan de su cache al crearlos y
+ * vuelven a ella al cerrarlos el ultimo proceso; las entradas libres
+ * de sus tablas valen NULL. Las tablas solo limitan cuantos puede
+ * haber, ya que su posicion es la que guardan los descriptores.
+ */
+
+#define NUM_SEM 16 /* numero total de semaforos en el sistema */
+#define NUM_COND 16 /* numero total de variables condicion en el sistema */
+
+typedef struct {
+	int valor;		// Contador del semaforo
+	int num_procs_en_sem;	// Indica numero de procesos que lo tienen abierto
+	lista_BCPs bloqueados;	// Procesos esperando en wait_sem
+} tipo_semaforo;
+
+tipo_semaforo *semaforos[NUM_SEM];
+tipo_cache *cache_sem;
+
+typedef struct {
+	int num_procs_en_cond;	// Indica numero de procesos que la tienen abierta
+	lista_BCPs bloqueados;	// Procesos esperando en wait_cond
+} tipo_condicion;
+
+tipo_condicion *condiciones[NUM_COND];
+tipo_cache *cache_cond;
+
+
+// Especificacion de los cerrojos de LECTORES/ESCRITORES
+
+#define NUM_RW 16 /* numero total de cerrojos de lectores/escritores */
+
+#define RW_FIFO 0		/* se conceden en orden de llegada */
+#define RW_PREF_ESCRITORES 1	/* un escritor en espera adelanta a los lectores */
+
+#define RW_LECTURA 0
+#define RW_ESCRITURA 1
+
+typedef struct {
+	int num_procs_en_rw;	// Indica numero de procesos que lo tienen abierto
+	int tipo;		// RW_FIFO o RW_PREF_ESCRITORES
+	int lectores;		// Numero de lectores que lo tienen concedido
+	int escritor;		// Id del escritor que lo tiene concedido o -1
+	int escritores_esperando;
+	lista_BCPs bloqueados;	// Lectores y escritores en orden de llegada
+} tipo_rwlock;
+
+tipo_rwlock *cerrojos_rw[NUM_RW];
+tipo_cache *cache_rw;
+
+
+// Especificacion de la MEMORIA COMPARTIDA
+
+#define NUM_MEM_COMP 8 /* numero total de regiones compartidas */
+#define TAM_MAX_MEM_COMP 16384 /* tamano maximo de una region */
+
+/*
+* Todas las imagenes de los procesos residen en el mismo espacio de
+* direcciones, por lo que proyectar una region en un proceso consiste en
+* darle un descriptor y la direccion de la zona reservada por el kernel.
+*/
+typedef struct {
+	int num_procs_en_mem;	// Indica numero de procesos que la tienen proyectada
+	int tam;		// Tamano solicitado al crearla
+} tipo_mem_comp;
+
+tipo_mem_comp mem_comp[NUM_MEM_COMP];
+
+char zona_mem_comp[NUM_MEM_COMP][TAM_MAX_MEM_COMP] __attribute__((aligned(4096)));
+
+
+// Especificacion de las COLAS DE MENSAJES
+
+#define NUM_COLAS 8 /* numero total de colas de mensajes */
+#define MAX_MENSAJES 16 /* capacidad maxima de una cola */
+#define TAM_MAX_MENSAJE 64 /* tamano maximo de un mensaje */
+
+typedef struct {
+	int num_procs_en_cola;	// Indica numero de procesos que la tienen abierta
+	int capacidad;		// Numero de mensajes que caben en la cola
+	int tam_mensaje;	// Tamano maximo de cada mensaje
+	int primero;		// Posicion del mensaje mas antiguo
+	int num_mensajes;	// Mensajes almacenados
+	int longitudes[MAX_MENSAJES];
+	char mensajes[MAX_MENSAJES][TAM_MAX_MENSAJE];
+	lista_BCPs esperando_hueco;	// Emisores bloqueados con la cola llena
+	lista_BCPs esperando_mensaje;	// Receptores bloqueados con la cola vacia
+} tipo_cola;
+
+tipo_cola *colas[NUM_COLAS];
+tipo_cache *cache_cola;
+
+
+/*
+* Registro de nombres de los objetos de sincronizacion. Cada tipo de
+* objeto tiene su propio espacio de nombres.
+*/
+#define NUM_NOMBRES (MAX_MUT+NUM_SEM+NUM_COND+NUM_RW+NUM_MEM_COMP+NUM_COLAS)
+
+typedef struct {
+	int usado;
+	int tipo;	/* OBJ_MUTEX|OBJ_SEM|OBJ_COND|OBJ_RW|OBJ_MEM|OBJ_COLA */
+	int id;		/* posicion del objeto en la tabla de su tipo */
+	char nombre[MAX_NOM_MUT+1];
+} tipo_nombre;
+
+tipo_nombre registro_nombres[NUM_NOMBRES];
 
 
 /*
@@ -182,37 +586,20 @@ tipo_buffer buffer[TAM_BUF_TERM];
 /*
  * Prototipos de las rutinas que realizan cada llamada al sistema
  */
-int sis_crear_proceso();
-int sis_terminar_proceso();
-int sis_escribir();
-
-/* Funcionalidad adicional */
-int sis_obtener_id_pr();
-int sis_dormir();
-int sis_tiempos_proceso();
-int sis_crear_mutex();
-int sis_abrir_mutex();
-int sis_lock();
-int sis_unlock();
-int sis_cerrar_mutex();
-//int sis_leer_caracter();
-
+#define PROTOTIPO_LLAMADA(clase, NUMERO, nombre, ...) int sis_##nombre();
+LISTA_LLAMADAS(PROTOTIPO_LLAMADA)
+#undef PROTOTIPO_LLAMADA
 
 /*
  * Variable global que contiene las rutinas que realizan cada llamada
+ * y el numero de argumentos de cada una, indexadas por su numero
  */
-servicio tabla_servicios[NSERVICIOS]={	{sis_crear_proceso},
-					{sis_terminar_proceso},
-					{sis_escribir},
-					{sis_obtener_id_pr},
-					{sis_dormir},
-					{sis_tiempos_proceso},
-					{sis_crear_mutex},
-					{sis_abrir_mutex},
-					{sis_lock},
-					{sis_unlock},
-					{sis_cerrar_mutex}};//,
-					//{sis_leer_caracter}};
+#define ENTRADA_LLAMADA(clase, NUMERO, nombre, nargs, ...) \
+	[NUMERO]={sis_##nombre, nargs},
+servicio tabla_servicios[NSERVICIOS]={
+	LISTA_LLAMADAS(ENTRADA_LLAMADA)
+};
+#undef ENTRADA_LLAMADA
 
 #endif /* _KERNEL_H */
 
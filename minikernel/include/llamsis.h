@@ -9,7 +9,10 @@
 
 /*
  *
- * Fichero de cabecera que contiene el numero asociado a cada llamada
+ * Fichero de cabecera que contiene la especificacion de cada llamada.
+ * De esta unica lista se obtienen los numeros de llamada, la tabla de
+ * servicios del nucleo y las funciones de interfaz de la biblioteca con
+ * sus prototipos.
  *
  * 	SE DEBE MODIFICAR PARA INCLUIR NUEVAS LLAMADAS
  *
@@ -18,21 +21,133 @@
 #ifndef _LLAMSIS_H
 #define _LLAMSIS_H
 
-/* Numero de llamadas disponibles */
-#define NSERVICIOS 12
+/*
+ * Cada entrada es LLAMADA(clase, NUMERO, nombre, nargs, (parametros),
+ * argumentos...). El numero de la llamada es su posicion en la lista,
+ * por lo que las nuevas se anaden siempre al final. nargs indica
+ * cuantos registros lee el nucleo. La rutina del nucleo es sis_nombre;
+ * si la clase es GENERADA la funcion de interfaz nombre(parametros) y
+ * su prototipo se generan a partir de esta entrada, y si es MANUAL se
+ * escriben a mano en serv.c y servicios.h.
+ */
+#define LISTA_LLAMADAS(LLAMADA) \
+	LLAMADA(GENERADA, CREAR_PROCESO, crear_proceso, 1, \
+		(char *prog), prog) \
+	LLAMADA(MANUAL, TERMINAR_PROCESO, terminar_proceso, 1, \
+		(int estado), estado) \
+	LLAMADA(GENERADA, ESCRIBIR, escribir, 2, \
+		(char *texto, unsigned int longi), texto, longi) \
+	LLAMADA(GENERADA, OBTENER_ID_PR, obtener_id_pr, 0, \
+		()) \
+	LLAMADA(GENERADA, DORMIR, dormir, 1, \
+		(unsigned int segundos), segundos) \
+	LLAMADA(GENERADA, TIEMPOS_PROCESO, tiempos_proceso, 1, \
+		(struct tiempos_ejec *t_ejec), t_ejec) \
+	LLAMADA(GENERADA, CREAR_MUTEX, crear_mutex, 2, \
+		(char *nombre, int tipo), nombre, tipo) \
+	LLAMADA(GENERADA, ABRIR_MUTEX, abrir_mutex, 1, \
+		(char *nombre), nombre) \
+	LLAMADA(GENERADA, LOCK, lock, 1, \
+		(unsigned int mutexid), mutexid) \
+	LLAMADA(GENERADA, UNLOCK, unlock, 1, \
+		(unsigned int mutexid), mutexid) \
+	LLAMADA(GENERADA, CERRAR_MUTEX, cerrar_mutex, 1, \
+		(unsigned int mutexid), mutexid) \
+	LLAMADA(GENERADA, CREAR_SEM, crear_sem, 2, \
+		(char *nombre, int valor), nombre, valor) \
+	LLAMADA(GENERADA, ABRIR_SEM, abrir_sem, 1, \
+		(char *nombre), nombre) \
+	LLAMADA(GENERADA, WAIT_SEM, wait_sem, 1, \
+		(unsigned int semid), semid) \
+	LLAMADA(GENERADA, SIGNAL_SEM, signal_sem, 1, \
+		(unsigned int semid), semid) \
+	LLAMADA(GENERADA, CERRAR_SEM, cerrar_sem, 1, \
+		(unsigned int semid), semid) \
+	LLAMADA(GENERADA, CREAR_COND, crear_cond, 1, \
+		(char *nombre), nombre) \
+	LLAMADA(GENERADA, ABRIR_COND, abrir_cond, 1, \
+		(char *nombre), nombre) \
+	LLAMADA(GENERADA, WAIT_COND, wait_cond, 2, \
+		(unsigned int condid, unsigned int mutexid), condid, mutexid) \
+	LLAMADA(GENERADA, SIGNAL_COND, signal_cond, 1, \
+		(unsigned int condid), condid) \
+	LLAMADA(GENERADA, BROADCAST_COND, broadcast_cond, 1, \
+		(unsigned int condid), condid) \
+	LLAMADA(GENERADA, CERRAR_COND, cerrar_cond, 1, \
+		(unsigned int condid), condid) \
+	LLAMADA(GENERADA, CREAR_RW, crear_rw, 2, \
+		(char *nombre, int tipo), nombre, tipo) \
+	LLAMADA(GENERADA, ABRIR_RW, abrir_rw, 1, \
+		(char *nombre), nombre) \
+	LLAMADA(GENERADA, LOCK_LECTURA, lock_lectura, 1, \
+		(unsigned int rwid), rwid) \
+	LLAMADA(GENERADA, LOCK_ESCRITURA, lock_escritura, 1, \
+		(unsigned int rwid), rwid) \
+	LLAMADA(GENERADA, UNLOCK_RW, unlock_rw, 1, \
+		(unsigned int rwid), rwid) \
+	LLAMADA(GENERADA, CERRAR_RW, cerrar_rw, 1, \
+		(unsigned int rwid), rwid) \
+	LLAMADA(MANUAL, CREAR_MEM_COMP, crear_mem_comp, 3, \
+		(char *nombre, int tam, void **dir), nombre, tam, dir) \
+	LLAMADA(MANUAL, ABRIR_MEM_COMP, abrir_mem_comp, 2, \
+		(char *nombre, void **dir), nombre, dir) \
+	LLAMADA(MANUAL, CERRAR_MEM_COMP, cerrar_mem_comp, 1, \
+		(void *dir), dir) \
+	LLAMADA(GENERADA, CREAR_COLA, crear_cola, 3, \
+		(char *nombre, int capacidad, int tam_mensaje), \
+		nombre, capacidad, tam_mensaje) \
+	LLAMADA(GENERADA, ABRIR_COLA, abrir_cola, 1, \
+		(char *nombre), nombre) \
+	LLAMADA(MANUAL, ENVIAR, enviar, 4, \
+		(unsigned int colaid, char *mensaje, int longitud, \
+		int no_bloquear), colaid, mensaje, longitud, no_bloquear) \
+	LLAMADA(MANUAL, RECIBIR, recibir, 4, \
+		(unsigned int colaid, char *buf, int longitud, \
+		int no_bloquear), colaid, buf, longitud, no_bloquear) \
+	LLAMADA(GENERADA, CERRAR_COLA, cerrar_cola, 1, \
+		(unsigned int colaid), colaid) \
+	LLAMADA(MANUAL, CREAR_HILO, crear_hilo, 3, \
+		(void *inicio, int (*funcion)(void *), void *arg), \
+		inicio, funcion, arg) \
+	LLAMADA(MANUAL, DATOS_HILO, datos_hilo, 2, \
+		(void **funcion, void **arg), funcion, arg) \
+	LLAMADA(GENERADA, TERMINAR_HILO, terminar_hilo, 1, \
+		(int valor), valor) \
+	LLAMADA(GENERADA, ESPERAR_HILO, esperar_hilo, 2, \
+		(int id, int *valor), id, valor) \
+	LLAMADA(GENERADA, ESPERAR_PROCESO, esperar_proceso, 3, \
+		(int pid, int *estado, struct tiempos_ejec *uso), \
+		pid, estado, uso) \
+	LLAMADA(GENERADA, CREAR_PROCESOS, crear_procesos, 3, \
+		(char *prog, int n, int *pids), prog, n, pids) \
+	LLAMADA(GENERADA, PERFIL, perfil, 3, \
+		(unsigned int *buf, int tam, int escala), buf, tam, escala) \
+	LLAMADA(MANUAL, OBTENER_ESTADISTICAS, obtener_estadisticas, 2, \
+		(struct estadisticas *e, int tam), e, tam) \
+	LLAMADA(GENERADA, LISTAR_PROCESOS, listar_procesos, 4, \
+		(struct info_proceso *buf, int max, \
+		struct info_descriptor *descs, int max_descs), \
+		buf, max, descs, max_descs) \
+	LLAMADA(GENERADA, LISTAR_MUTEX, listar_mutex, 2, \
+		(struct info_mutex *buf, int max), buf, max) \
+	LLAMADA(GENERADA, TRYLOCK, trylock, 1, \
+		(unsigned int mutexid), mutexid) \
+	LLAMADA(GENERADA, LOCK_TIMEOUT, lock_timeout, 2, \
+		(unsigned int mutexid, int ms), mutexid, ms) \
+	LLAMADA(GENERADA, FIJAR_MODO_MUTEX, fijar_modo_mutex, 2, \
+		(unsigned int mutexid, int modo), mutexid, modo) \
+	LLAMADA(MANUAL, OBTENER_PAGINA_INFO, obtener_pagina_info, 1, \
+		(const struct pagina_info **dir), dir) \
+	LLAMADA(GENERADA, OBTENER_LATENCIAS, obtener_latencias, 1, \
+		(struct latencias *l), l)
+	/* LLAMADA(GENERADA, LEER_CARACTER, leer_caracter, 0, ()) */
 
-#define CREAR_PROCESO 0
-#define TERMINAR_PROCESO 1
-#define ESCRIBIR 2
-#define OBTENER_ID_PR 3
-#define DORMIR 4
-#define TIEMPOS_PROCESO 5
-#define LEER_CARACTER 6
-#define CREAR_MUTEX 7
-#define ABRIR_MUTEX 8
-#define LOCK 9
-#define UNLOCK 10
-#define CERRAR_MUTEX 11
+/* Maximo numero de argumentos de una llamada (registros 1 a 5) */
+#define MAX_ARGS_LLAMADA 5
 
-#endif /* _LLAMSIS_H */
+/* Numero asociado a cada llamada y numero de llamadas disponibles */
+#define NUMERO_LLAMADA(clase, NUMERO, ...) NUMERO,
+enum { LISTA_LLAMADAS(NUMERO_LLAMADA) NSERVICIOS };
+#undef NUMERO_LLAMADA
 
+#endif /* _LLAMSIS_H */
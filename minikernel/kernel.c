@@ -13,8 +13,120 @@
  *
  */
 
+#define _GNU_SOURCE	/* dladdr, memfd_create */
 #include "kernel.h"	/* Contiene defs. usadas por este modulo */
 #include "string.h"
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <time.h>
+#include <link.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/*
+ *
+ * Medida de las secciones con las interrupciones enmascaradas:
+ *	empezar_enmascarado terminar_enmascarado fijar_nivel_medido
+ *
+ */
+
+/*
+ * Instante actual en nanosegundos segun el reloj monotonico del anfitrion
+ */
+static long long ahora_ns(){
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (long long)t.tv_sec*1000000000LL + t.tv_nsec;
+}
+
+/*
+ * Abre una seccion enmascarada. Si habia otra abierta es que termino
+ * sin pasar por fijar_nivel_medido (p.ej. al arrancar un proceso nuevo
+ * con su contexto inicial) y se descarta.
+ */
+static void empezar_enmascarado(const char *funcion, int linea){
+	enmascarado.abierta=1;
+	enmascarado.funcion=funcion;
+	enmascarado.linea=linea;
+	enmascarado.inicio=ahora_ns();
+}
+
+/*
+ * Anota una seccion enmascarada de dur nanosegundos en el histograma y
+ * en el sitio que la abrio.
+ */
+static void anotar_enmascarado(const char *funcion, int linea,
+				long long dur){
+	tipo_sitio *s;
+	int c, i;
+
+	latencias.secciones++;
+	for (c=0; (c<NUM_CUBETAS_LATENCIA-1) && (dur/1000>=(1LL<<c)); c++);
+	latencias.histograma[c]++;
+
+	for (i=0; i<latencias.sitios; i++)
+		if ((sitios_latencia[i].funcion==funcion) &&
+			(sitios_latencia[i].linea==linea))
+			break;
+	if (i==latencias.sitios) {
+		if (i==MAX_SITIOS_LATENCIA) {
+			latencias.sitios_perdidos++;
+			return;
+		}
+		latencias.sitios++;
+		sitios_latencia[i].funcion=funcion;
+		sitios_latencia[i].linea=linea;
+	}
+	s=&sitios_latencia[i];
+	s->veces++;
+	s->total_ns+=dur;
+	if (dur>s->max_ns)
+		s->max_ns=dur;
+}
+
+/*
+ * Cierra la seccion abierta. Se llama todavia a NIVEL_3.
+ */
+static void terminar_enmascarado(){
+	enmascarado.abierta=0;
+	anotar_enmascarado(enmascarado.funcion, enmascarado.linea,
+		ahora_ns()-enmascarado.inicio);
+}
+
+/*
+ * Envoltorio de fijar_nivel_int de la HAL que mide las secciones
+ * enmascaradas. Al bajar el nivel la seccion abierta se retira antes
+ * de la llamada, para que una interrupcion pendiente no la encuentre,
+ * y solo se anota si el nivel previo era de verdad NIVEL_3; si no, es
+ * una seccion que termino sin pasar por aqui (un proceso nuevo arranca
+ * a nivel 0 desde su contexto inicial) y se descarta.
+ */
+static int fijar_nivel_medido(int nivel, const char *funcion, int linea){
+	struct seccion_enmascarada seccion;
+	long long fin=0;
+	int anterior;
+
+	seccion.abierta=0;
+	if ((nivel<NIVEL_3) && enmascarado.abierta) {
+		seccion=enmascarado;
+		enmascarado.abierta=0;
+		fin=ahora_ns();
+	}
+	anterior=fijar_nivel_int(nivel);
+	if (seccion.abierta && (anterior==NIVEL_3))
+		anotar_enmascarado(seccion.funcion, seccion.linea,
+			fin-seccion.inicio);
+	if ((nivel==NIVEL_3) && (anterior<NIVEL_3))
+		empezar_enmascarado(funcion, linea);
+	return anterior;
+}
+
+/* a partir de aqui todo cambio de nivel queda medido con su sitio */
+#define fijar_nivel_int(nivel) fijar_nivel_medido((nivel), __func__, __LINE__)
 
 /*
  *
@@ -65,6 +177,16 @@ static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
 	proc->siguiente=NULL;
 }
 
+/*
+ * Inserta un BCP al principio de la lista.
+ */
+static void insertar_primero(lista_BCPs *lista, BCP * proc){
+	if (lista->primero==NULL)
+		lista->ultimo= proc;
+	proc->siguiente=lista->primero;
+	lista->primero= proc;
+}
+
 /*
  * Elimina el primer BCP de la lista.
  */
@@ -94,23 +216,81 @@ static void eliminar_elem(lista_BCPs *lista, BCP * proc){
 	}
 }
 
+/*
+ * Devuelve el numero de BCPs de la lista.
+ */
+static int longitud_lista(lista_BCPs *lista){
+	BCP *paux;
+	int n=0;
+
+	for (paux=lista->primero; paux; paux=paux->siguiente)
+		n++;
+	return n;
+}
+
+/*
+ *
+ * Funciones de manejo de la cola de listos
+ *	encolar_listo sacar_listo num_listos
+ *
+ */
+
+/*
+ * Inserta un proceso al final de la cola de listos. Un proceso que ya
+ * estuviera en ella la dejara corrupta, por lo que se comprueba.
+ */
+static void encolar_listo(BCP *p_proc){
+	BCP *p;
+
+	for (p=lista_listos.primero; p!=NULL; p=p->siguiente)
+		if (p==p_proc)
+			panico("proceso encolado dos veces en listos");
+	insertar_ultimo(&lista_listos, p_proc);
+}
+
+/*
+ * Saca un proceso de la cola de listos
+ */
+static void sacar_listo(BCP *p_proc){
+	eliminar_elem(&lista_listos, p_proc);
+}
+
+/*
+ * Devuelve el numero de procesos listos, incluido el que ejecuta
+ */
+static int num_listos(){
+	return longitud_lista(&lista_listos);
+}
+
 /*
  *
  * Funciones relacionadas con la planificacion
  *	espera_int planificador
  */
 
+static void ejecutar_sirq();
+static void activar_sirq(int n);
+
 /*
  * Espera a que se produzca una interrupcion
  */
 static void espera_int(){
 	int nivel;
 
-	printk("-> NO HAY LISTOS. ESPERA INT\n");
-
-	/* Baja al mnimo el nivel de interrupcin mientras espera */
-	nivel=fijar_nivel_int(NIVEL_1);
-	halt();
+	/* una interrupcion llegada desde que el proceso ocioso miro la cola
+	   puede haber dejado trabajo diferido o un proceso listo: se
+	   comprueba con todo enmascarado y solo se para si no hay nada */
+	nivel=fijar_nivel_int(NIVEL_RELOJ);
+	if ((sirq_pendientes==0) && (num_listos()==0)) {
+		/* Baja al mnimo el nivel de interrupcin mientras espera */
+		fijar_nivel_int(NIVEL_1);
+		halt();
+	}
+	else
+		fijar_nivel_int(NIVEL_1);
+	/* a NIVEL_1 no llega la interrupcion software: el trabajo que
+	   haya diferido la interrupcion que nos desperto se hace aqui */
+	ejecutar_sirq();
 	fijar_nivel_int(nivel);
 }
 
@@ -118,11 +298,276 @@ static void espera_int(){
  * Funcin de planificacion que implementa un algoritmo FIFO.
  */
 static BCP * planificador(){
-	while (lista_listos.primero==NULL)
-		espera_int();		/* No hay nada que hacer */
+	if (lista_listos.primero==NULL)
+		return &bcp_ocioso;	/* No hay nada que hacer */
 	return lista_listos.primero;
 }
 
+/*
+ * Libera los mapas y pilas de procesos terminados que quedaron pendientes
+ */
+static void recoger_pendientes(){
+	while (num_pendientes>0) {
+		num_pendientes--;
+		if (pendientes[num_pendientes].info_mem!=NULL)
+			liberar_imagen(pendientes[num_pendientes].info_mem);
+		liberar_pila(pendientes[num_pendientes].pila);
+	}
+}
+
+/*
+ * Aplaza la liberacion de un mapa (NULL si no hay que liberarlo) y de
+ * una pila. Si ya hay demasiados pendientes se liberan antes esos.
+ */
+static void aplazar_liberacion(void *info_mem, void *pila){
+	if (num_pendientes==MAX_PENDIENTES)
+		recoger_pendientes();
+	pendientes[num_pendientes].info_mem=info_mem;
+	pendientes[num_pendientes].pila=pila;
+	num_pendientes++;
+}
+
+/*
+ * Registra una funcion que el proceso ocioso ejecuta cada vez que no
+ * hay procesos listos, antes de esperar la siguiente interrupcion.
+ * Return: 0 si exito; -1 si no caben mas
+ */
+static int registrar_trabajo_ocioso(trabajo_ocioso trabajo){
+	if (num_trabajos_ocioso==MAX_TRABAJOS_OCIOSO)
+		return -1;
+	trabajos_ocioso[num_trabajos_ocioso++]=trabajo;
+	return 0;
+}
+
+/*
+ * Bucle del proceso ocioso, que ejecuta sobre el contexto de arranque.
+ * Nunca esta en la cola de listos: el planificador lo elige cuando no
+ * hay otro proceso y cede el procesador en cuanto aparece alguno.
+ */
+static void bucle_ocioso(){
+	int i;
+
+	for (;;) {
+		fijar_nivel_int(NIVEL_CAMBIO);
+		p_proc_actual=planificador();
+		if (p_proc_actual!=&bcp_ocioso) {
+			printk("-> C.CONTEXTO DESDE OCIOSO a %d\n",
+				p_proc_actual->id);
+			estadisticas.cambios[CAMBIO_OCIOSO]++;
+			cambio_contexto(&(bcp_ocioso.contexto_regs),
+					&(p_proc_actual->contexto_regs));
+			printk("-> NO HAY LISTOS. PROCESO OCIOSO\n");
+		}
+		else {
+			/* los trabajos pueden ser largos (liberar mapas y
+			   pilas): no se hacen con el reloj enmascarado */
+			fijar_nivel_int(NIVEL_LISTAS);
+			for (i=0; i<num_trabajos_ocioso; i++)
+				trabajos_ocioso[i]();
+			espera_int();
+		}
+	}
+}
+
+/*
+ *
+ * Funciones auxiliares de bloqueo usadas por los objetos de sincronizacion
+ *	bloquear_proceso desbloquear_proceso
+ *
+ */
+
+/*
+ * Bloquea al proceso actual en la lista indicada y cede el procesador
+ * al siguiente proceso listo. Retorna cuando otro proceso lo desbloquea.
+ */
+static void bloquear_proceso(lista_BCPs *lista){
+	BCP * p_proc_anterior;
+	int nivel;
+
+	nivel=fijar_nivel_int(NIVEL_LISTAS);
+	p_proc_actual->estado=BLOQUEADO;
+	p_proc_actual->lista_bloqueo=lista;
+	// Ya no es necesario hacer cambio de contexto involuntario
+	p_proc_actual->replanificacion=0;
+	sacar_listo(p_proc_actual);
+	insertar_ultimo(lista, p_proc_actual);
+
+	fijar_nivel_int(NIVEL_CAMBIO);
+	p_proc_anterior=p_proc_actual;
+	p_proc_actual=planificador();
+
+	printk("-> C.CONTEXTO POR BLOQUEO: de %d a %d\n",
+			p_proc_anterior->id, p_proc_actual->id);
+	estadisticas.cambios[CAMBIO_BLOQUEO]++;
+
+	cambio_contexto(&(p_proc_anterior->contexto_regs),
+			&(p_proc_actual->contexto_regs));
+	fijar_nivel_int(nivel);
+}
+
+/*
+ * Pasa a listo al primer proceso de la lista indicada.
+ * Return: el proceso desbloqueado
+ * Return: NULL si no habia ninguno esperando
+ */
+static BCP * desbloquear_proceso(lista_BCPs *lista){
+	BCP * p_proc;
+	int nivel;
+
+	nivel=fijar_nivel_int(NIVEL_LISTAS);
+	p_proc=lista->primero;
+	if (p_proc!=NULL) {
+		p_proc->estado=LISTO;
+		eliminar_primero(lista);
+		encolar_listo(p_proc);
+	}
+	fijar_nivel_int(nivel);
+	return p_proc;
+}
+
+/*
+ * Pasa a listo a un proceso concreto de la lista indicada.
+ */
+static void desbloquear_elem(lista_BCPs *lista, BCP * p_proc){
+	int nivel;
+
+	nivel=fijar_nivel_int(NIVEL_LISTAS);
+	p_proc->estado=LISTO;
+	eliminar_elem(lista, p_proc);
+	encolar_listo(p_proc);
+	fijar_nivel_int(nivel);
+}
+
+/*
+ *
+ * Funciones del asignador de objetos del nucleo
+ *	crear_cache reservar_objeto liberar_objeto
+ *
+ */
+
+/*
+ * Da de alta una cache para objetos de tam bytes. El constructor, si lo
+ * hay, se aplica a cada objeto una sola vez, al sacarlo de la arena;
+ * quien libera un objeto debe dejarlo en el estado construido.
+ * Return: la cache; NULL si no caben mas caches
+ */
+static tipo_cache * crear_cache(char *nombre, int tam,
+				void (*constructor)(void *objeto)){
+	tipo_cache *c;
+
+	if (num_caches==MAX_CACHES)
+		return NULL;
+	c=&caches[num_caches++];
+	strncpy(c->uso.nombre, nombre, MAX_NOM_CACHE);
+	c->uso.nombre[MAX_NOM_CACHE]='\0';
+	c->uso.tam_objeto=tam;
+	c->tam_hueco=(tam+sizeof(void *)-1)/sizeof(void *)*sizeof(void *)+
+		sizeof(enlace_slab);
+	c->constructor=constructor;
+	c->libres=NULL;
+	return c;
+}
+
+/*
+ * Funcion auxiliar que toma un slab de la arena, construye sus objetos
+ * y los pasa a la lista de libres de la cache.
+ * Return: 0 si se ha podido; -1 si la arena esta agotada
+ */
+static int crecer_cache(tipo_cache *c){
+	char *slab, *objeto;
+	enlace_slab *enlace;
+	int n, i;
+
+	if (slabs_usados==NUM_SLABS)
+		return -1;
+	slab=(char *)arena_slab[slabs_usados++];
+	n=TAM_SLAB/c->tam_hueco;
+	/* se recorre al reves para que queden en orden en la lista */
+	for (i=n-1; i>=0; i--) {
+		objeto=slab+i*c->tam_hueco;
+		if (c->constructor)
+			c->constructor(objeto);
+		enlace=(enlace_slab *)(objeto+c->tam_hueco)-1;
+		enlace->siguiente=c->libres;
+		c->libres=enlace;
+	}
+	c->uso.slabs++;
+	c->uso.objetos+=n;
+	return 0;
+}
+
+/*
+ * Saca un objeto construido de la cache. Solo si no le quedan libres
+ * se toma un slab nuevo de la arena.
+ * Return: el objeto; NULL si no queda memoria
+ */
+static void * reservar_objeto(tipo_cache *c){
+	enlace_slab *enlace;
+
+	if ((c->libres==NULL) && (crecer_cache(c)<0)) {
+		c->uso.fallos++;
+		return NULL;
+	}
+	enlace=c->libres;
+	c->libres=enlace->siguiente;
+	if (++c->uso.en_uso>c->uso.max_en_uso)
+		c->uso.max_en_uso=c->uso.en_uso;
+	return (char *)(enlace+1)-c->tam_hueco;
+}
+
+/*
+ * Devuelve a la cache un objeto que ya esta en su estado construido.
+ */
+static void liberar_objeto(tipo_cache *c, void *objeto){
+	enlace_slab *enlace;
+
+	enlace=(enlace_slab *)((char *)objeto+c->tam_hueco)-1;
+	enlace->siguiente=c->libres;
+	c->libres=enlace;
+	c->uso.en_uso--;
+}
+
+static void cerrar_descriptores();
+
+/*
+ * Funcion auxiliar por la que el proceso actual deja de usar su imagen.
+ * Si era el ultimo hilo que la usaba se descartan los hilos terminados
+ * cuyo valor ya nadie puede recoger; el mapa lo libera el llamante.
+ * Return: numero de hilos que siguen usando la imagen
+ */
+static int soltar_imagen(){
+	tipo_imagen *imagen=p_proc_actual->imagen;
+	int i;
+
+	imagen->num_hilos--;
+	if (imagen->num_hilos>0)
+		return imagen->num_hilos;
+
+	for (i=0; i<MAX_PROC; i++)
+		if ((tabla_procs[i].estado==ZOMBI) && tabla_procs[i].es_hilo &&
+			(tabla_procs[i].imagen==imagen))
+			tabla_procs[i].estado=NO_USADA;
+	return 0;
+}
+
+/*
+ * Funcion auxiliar que deja huerfanos a los hijos del proceso actual.
+ * Los que ya terminaron se descartan, puesto que nadie va a esperarlos.
+ */
+static void abandonar_hijos(){
+	int i;
+
+	for (i=0; i<MAX_PROC; i++)
+		if ((tabla_procs[i].estado!=NO_USADA) &&
+			!tabla_procs[i].es_hilo &&
+			(tabla_procs[i].padre==p_proc_actual->id)) {
+			if (tabla_procs[i].estado==ZOMBI)
+				tabla_procs[i].estado=NO_USADA;
+			else
+				tabla_procs[i].padre=-1;
+		}
+}
+
 /*
  *
  * Funcion auxiliar que termina proceso actual liberando sus recursos.
@@ -131,20 +576,42 @@ static BCP * planificador(){
  */
 static void liberar_proceso(){
 	BCP * p_proc_anterior;
+	int quedan;
+
+	cerrar_descriptores(); /* cierre implicito de objetos de sincronizacion */
+	quedan=soltar_imagen();
+	abandonar_hijos();
+
+	/* se llega al nivel de quien termina: las listas no se pueden
+	   tocar sin subirlo, y no se restaura porque no se vuelve */
+	fijar_nivel_int(NIVEL_LISTAS);
+
+	/* un hilo queda ZOMBI hasta que otro hilo de su imagen recoja su
+	   valor de salida, y un proceso hasta que lo recoja su padre; si
+	   ya lo estaban esperando se les despierta */
+	if (p_proc_actual->es_hilo ? (quedan>0) : (p_proc_actual->padre>=0)) {
+		p_proc_actual->estado=ZOMBI;
+		desbloquear_proceso(&(p_proc_actual->esperando_fin));
+	}
+	else
+		p_proc_actual->estado=TERMINADO;
+	sacar_listo(p_proc_actual); /* proc. fuera de listos */
 
-	liberar_imagen(p_proc_actual->info_mem); /* liberar mapa */
-
-	p_proc_actual->estado=TERMINADO;
-	eliminar_primero(&lista_listos); /* proc. fuera de listos */
+	/* liberar mapa, si era el ultimo hilo, y pila fuera del camino
+	   del cambio de contexto */
+	aplazar_liberacion((quedan>0) ? NULL : p_proc_actual->info_mem,
+			p_proc_actual->pila);
 
 	/* Realizar cambio de contexto */
+	fijar_nivel_int(NIVEL_CAMBIO);
 	p_proc_anterior=p_proc_actual;
 	p_proc_actual=planificador();
 
 	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
 			p_proc_anterior->id, p_proc_actual->id);
+	estadisticas.cambios[CAMBIO_FIN]++;
+	estadisticas.procesos_terminados++;
 
-	liberar_pila(p_proc_anterior->pila);
 	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
         return; /* no debera llegar aqui */
 }
@@ -156,29 +623,36 @@ static void liberar_proceso(){
 */
 
 /*
-* Funcion auxiliar que el proceso actual tiene libre algun
-* descriptor.
+* Funcion auxiliar que busca un descriptor libre del proceso actual:
+* el primer bit a cero de su mapa de descriptores.
 * Return: Posicion si hay disponible
 * Return: -1 si error.
 */
 int existe_descriptor() {
-	int enc = 0;
-	int n = 0;
-	while((n < NUM_MUT_PROC) && (!enc)) {
-		//Comprobamos si tiene descriptor libre
-		if(p_proc_actual->descriptores[n].libre == 0) {
-			enc = 1;
+	unsigned int libres;
+	int w, pos;
+
+	for (w = 0; w < PALABRAS_MAPA(num_desc_proc); w++) {
+		libres = ~p_proc_actual->mapa_descriptores[w];
+		if (libres != 0) {
+			pos = w * BITS_PALABRA + __builtin_ctz(libres);
+			return (pos < num_desc_proc) ? pos : -1;
 		}
-		n++;
-	}
-	// Tratamiento de errores en caso de no haber
-	if(!enc) {
-		return -1;
-	}
-	else {
-		return n-1;
 	}
+	return -1;
+}
+
+/*
+* Constructor de los objetos de cache_mutex: un mutex libre, sin
+* procesos que lo tengan abierto ni esperando por el.
+*/
+static void construir_mutex(void *objeto) {
+	tipo_mutex *m = objeto;
 
+	m->num_procs_en_mutex = 0;
+	m->bloqueado = 0;
+	m->bloqueados.primero = NULL;
+	m->bloqueados.ultimo = NULL;
 }
 
 /*
@@ -191,104 +665,283 @@ int dame_libre() {
 	int enc = 0;
 	int n = 0;
 
-	while ((!enc) && (n<NUM_MUT)) {
+	while ((!enc) && (n<num_mut)) {
 		//Comprobamos si hay hueco libre
-		if(mutex[n].num_procs_en_mutex <= 0) {
+		if(mutex[n] == NULL) {
 			enc = 1;
 		}
 		n++;
 	}
 	if(!enc) {
-		return LLENO;
+		//Si no se ha llegado al limite se amplia la tabla un trozo
+		if(num_mut == MAX_MUT) {
+			return LLENO;
+		}
+		num_mut += TROZO_MUT;
+		if(num_mut > MAX_MUT) {
+			num_mut = MAX_MUT;
+		}
+		return n;
 	}
 	else return n-1;
 }
 
 /*
-* Funcion auxiliar que verifica si existe ya un MUTEX dado
-* Return: 1 si se ha encontrado
-* Return: 0 eoc.
+* Funcion auxiliar que despierta a los procesos bloqueados en crear_mutex
+* que pueden encontrar hueco: tantos como entradas libres quedan, sin
+* contar las que van a ocupar los despertados que aun no han ejecutado.
 */
-int mutex_exist(char*name) {
-	int enc = 0;
-	int n = 0;
+static void despertar_creadores() {
+	int huecos = MAX_MUT - cache_mutex->uso.en_uso - creadores_despertados;
 
-	while((n<NUM_MUT) && (!enc)) {
-		//Buscamos en indices que tengan mutex
-		if (mutex[n].num_procs_en_mutex > 0) {
-			//Verificamos si el nombre coincide
-			if(strcmp(name, mutex[n].nombre_mutex)) {
-				enc = 1;
-			}
-		}
-		n++;
-	}
-	if(!enc) {
-		return 0;
-	}
-	else {
-		return 1;
+	while((huecos-- > 0) && (desbloquear_proceso(&lista_de_mutex) != NULL)) {
+		creadores_despertados++;
 	}
 }
 
-int dame_posicion_en_mutex(char*nombre) {
-	int enc = 0;
-	int n = 0;
+/*
+* Funcion auxiliar que busca en el registro de nombres un objeto
+* del tipo indicado.
+* Return: posicion del objeto en la tabla de su tipo
+* Return: -1 si no existe
+*/
+static int buscar_nombre(int tipo, char *nombre) {
+	int n;
 
-	while((n<NUM_MUT) && (!enc)) {
-		//seleccionamos solo aquellos indices con un mutex
-		if (mutex[n].num_procs_en_mutex > 0) {
-			// Comparamos solo si coincide el nombre
-			if(strcmp(nombre, mutex[n].nombre_mutex) == 0) {
-				enc = 1;
-			}
-		}
-		n++;
-	}
-	if(!enc) {
-		return -1;
-	}
-	else {
-		return n-1;
-	}
+	for (n=0; n<NUM_NOMBRES; n++)
+		if (registro_nombres[n].usado && (registro_nombres[n].tipo == tipo)
+			&& (strcmp(registro_nombres[n].nombre, nombre) == 0))
+			return registro_nombres[n].id;
+	return -1;
 }
 
 /*
- *
- * Funciones relacionadas con el tratamiento de interrupciones
- *	excepciones: exc_arit exc_mem
- *	interrupciones de reloj: int_reloj
- *	interrupciones del terminal: int_terminal
- *	llamadas al sistemas: llam_sis
- *	interrupciones SW: int_sw
- *
- */
+* Funcion auxiliar que da de alta el nombre de un objeto en el registro.
+* Return: 0 si se ha registrado
+* Return: -1 si el nombre es demasiado largo o el registro esta lleno
+*/
+static int registrar_nombre(int tipo, char *nombre, int id) {
+	int n;
+
+	if (strlen(nombre) > MAX_NOM_MUT)
+		return -1;
+	for (n=0; n<NUM_NOMBRES; n++)
+		if (!registro_nombres[n].usado) {
+			registro_nombres[n].usado = 1;
+			registro_nombres[n].tipo = tipo;
+			registro_nombres[n].id = id;
+			strcpy(registro_nombres[n].nombre, nombre);
+			return 0;
+		}
+	return -1;
+}
 
 /*
- * Tratamiento de excepciones aritmeticas
- */
-static void exc_arit(){
+* Funcion auxiliar que da de baja el nombre de un objeto destruido
+*/
+static void borrar_nombre(int tipo, int id) {
+	int n;
 
-	if (!viene_de_modo_usuario())
-		panico("excepcion aritmetica cuando estaba dentro del kernel");
+	for (n=0; n<NUM_NOMBRES; n++)
+		if (registro_nombres[n].usado && (registro_nombres[n].tipo == tipo)
+			&& (registro_nombres[n].id == id))
+			registro_nombres[n].usado = 0;
+}
 
+/*
+* Funcion auxiliar que indica si la entrada pos de la tabla de
+* descriptores del proceso esta ocupada.
+*/
+static int descriptor_ocupado(BCP *p_proc, int pos) {
+	return (p_proc->mapa_descriptores[pos / BITS_PALABRA]
+		>> (pos % BITS_PALABRA)) & 1;
+}
 
-	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+/*
+* Funcion auxiliar que recorre los descriptores ocupados de un proceso.
+* Return: Posicion del primero ocupado a partir de desde
+* Return: -1 si no queda ninguno
+*/
+static int siguiente_descriptor(BCP *p_proc, int desde) {
+	unsigned int mapa;
+	int w = desde / BITS_PALABRA;
 
-        return; /* no debera llegar aqui */
+	if (desde >= num_desc_proc)
+		return -1;
+	mapa = p_proc->mapa_descriptores[w] & (~0U << (desde % BITS_PALABRA));
+	for (;;) {
+		if (mapa != 0)
+			return w * BITS_PALABRA + __builtin_ctz(mapa);
+		if (++w == PALABRAS_MAPA(num_desc_proc))
+			return -1;
+		mapa = p_proc->mapa_descriptores[w];
+	}
 }
 
 /*
- * Tratamiento de excepciones en el acceso a memoria
- */
-static void exc_mem(){
+* Funcion auxiliar que comprueba que desc es un descriptor vigente del
+* proceso actual y que referencia a un objeto del tipo indicado.
+* Return: Posicion del descriptor
+* Return: -1 si el proceso no tiene abierto el objeto
+*/
+static int buscar_descriptor(int tipo, unsigned int desc) {
+	int n = desc & MASCARA_DESC;
+	tipo_descriptor *d;
+
+	if ((n >= num_desc_proc) || !descriptor_ocupado(p_proc_actual, n))
+		return -1;
+	d = &p_proc_actual->descriptores[n];
+	if ((d->tipo != tipo) || (d->generacion != (desc >> BITS_DESC)))
+		return -1;
+	return n;
+}
+
+/*
+* Funcion auxiliar que traduce un descriptor del proceso actual al
+* indice del objeto que referencia.
+* Return: indice del objeto
+* Return: -1 si el proceso no tiene abierto el objeto
+*/
+static int objeto_descriptor(int tipo, unsigned int desc) {
+	int n = buscar_descriptor(tipo, desc);
+
+	if (n < 0)
+		return -1;
+	return p_proc_actual->descriptores[n].descript;
+}
+
+/*
+* Funcion auxiliar que busca, entre los descriptores ocupados del
+* proceso indicado, el que referencia al objeto indicado.
+* Return: Posicion del descriptor
+* Return: -1 si el proceso no tiene abierto el objeto
+*/
+static int descriptor_de_objeto(BCP *p_proc, int tipo, int id) {
+	int n;
+
+	for (n = siguiente_descriptor(p_proc, 0); n >= 0;
+		n = siguiente_descriptor(p_proc, n + 1)) {
+		if ((p_proc->descriptores[n].tipo == tipo)
+			&& (p_proc->descriptores[n].descript == id))
+			return n;
+	}
+	return -1;
+}
+
+/*
+* Funcion auxiliar que compone el descriptor que ve el usuario a partir
+* de la posicion y la generacion de la entrada.
+*/
+static int valor_descriptor(BCP *p_proc, int pos) {
+	return (int)((p_proc->descriptores[pos].generacion << BITS_DESC) | pos);
+}
+
+/*
+* Funcion auxiliar que da el descriptor con el que el proceso indicado
+* tiene abierto un objeto.
+* Return: el descriptor de usuario; -1 si no lo tiene abierto
+*/
+static int descriptor_usuario(BCP *p_proc, int tipo, int id) {
+	int pos = descriptor_de_objeto(p_proc, tipo, id);
+
+	return (pos < 0) ? -1 : valor_descriptor(p_proc, pos);
+}
+
+/*
+* Funcion auxiliar que asocia un descriptor libre del proceso actual
+* al objeto indicado.
+* Return: el descriptor que se devuelve al usuario
+*/
+static int ocupar_descriptor(int pos, int tipo, int id) {
+	tipo_descriptor *d = &p_proc_actual->descriptores[pos];
+
+	d->descript = id;
+	d->tipo = tipo;
+	d->lecturas = 0;
+	p_proc_actual->mapa_descriptores[pos / BITS_PALABRA] |=
+		1U << (pos % BITS_PALABRA);
+	return valor_descriptor(p_proc_actual, pos);
+}
+
+/*
+* Funcion auxiliar que libera un descriptor del proceso actual. Al
+* cambiar la generacion, el descriptor viejo deja de ser valido.
+*/
+static void liberar_descriptor(int pos) {
+	tipo_descriptor *d = &p_proc_actual->descriptores[pos];
+
+	p_proc_actual->mapa_descriptores[pos / BITS_PALABRA] &=
+		~(1U << (pos % BITS_PALABRA));
+	d->generacion = (d->generacion + 1) & MASCARA_GENERACION;
+}
+
+/*
+* Reserva en el arranque las tablas de descriptores de todos los BCPs,
+* con el tamano que indique MINIKERNEL_DESCRIPTORES.
+*/
+static void iniciar_descriptores() {
+	char *valor = getenv("MINIKERNEL_DESCRIPTORES");
+	size_t tam_tabla, tam_mapa;
+	char *zona;
+	int i;
+
+	num_desc_proc = (valor != NULL) ? atoi(valor) : DESC_PROC_DEFECTO;
+	if ((num_desc_proc <= 0) || (num_desc_proc > MAX_DESC_PROC))
+		num_desc_proc = DESC_PROC_DEFECTO;
+
+	tam_tabla = num_desc_proc * sizeof(tipo_descriptor);
+	tam_mapa = PALABRAS_MAPA(num_desc_proc) * sizeof(unsigned int);
+	zona = mmap(NULL, MAX_PROC * (tam_tabla + tam_mapa),
+		PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+	if (zona == MAP_FAILED)
+		panico("no se pueden reservar las tablas de descriptores");
+	for (i = 0; i < MAX_PROC; i++) {
+		tabla_procs[i].mapa_descriptores = (unsigned int *)zona;
+		zona += tam_mapa;
+		tabla_procs[i].descriptores = (tipo_descriptor *)zona;
+		zona += tam_tabla;
+	}
+}
+
+/*
+ *
+ * Funciones relacionadas con el tratamiento de interrupciones
+ *	excepciones: exc_arit exc_mem
+ *	interrupciones de reloj: int_reloj
+ *	interrupciones del terminal: int_terminal
+ *	llamadas al sistemas: llam_sis
+ *	interrupciones SW: int_sw
+ *
+ */
+
+/*
+ * Tratamiento de excepciones aritmeticas
+ */
+static void exc_arit(){
+
+	if (!viene_de_modo_usuario())
+		panico("excepcion aritmetica cuando estaba dentro del kernel");
+
+
+	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
+	p_proc_actual->valor_salida=-1;
+	liberar_proceso();
+
+        return; /* no debera llegar aqui */
+}
+
+/*
+ * Tratamiento de excepciones en el acceso a memoria
+ */
+static void exc_mem(){
 
 	if (!viene_de_modo_usuario())
 		panico("excepcion de memoria cuando estaba dentro del kernel");
 
 
+	/* los fallos de paginas validas aun no cargadas no llegan aqui */
 	printk("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
+	p_proc_actual->valor_salida=-1;
 	liberar_proceso();
 
         return; /* no debera llegar aqui */
@@ -307,75 +960,349 @@ static void int_terminal(){
 }
 
 /*
- * Tratamiento de interrupciones de reloj
+ * Indica si el fichero cargado es el ejecutable prog, comparando el
+ * ultimo componente de su ruta, con o sin extension.
+ */
+static int es_programa(const char *fichero, const char *prog){
+	const char *base=strrchr(fichero, '/');
+	int longi=strlen(prog);
+
+	base=(base ? base+1 : fichero);
+	return (strncmp(base, prog, longi)==0) &&
+		((base[longi]=='\0') || (base[longi]=='.'));
+}
+
+/*
+ * Obtiene el contador de programa de una muestra como desplazamiento
+ * dentro del ejecutable del proceso: es el primer marco de la pila del
+ * manejador que pertenece a su programa.
+ * Return: desplazamiento; -1 si no se encuentra
+ */
+static long pc_usuario(struct muestra_perfil *m){
+	Dl_info info;
+	int i;
+
+	for (i=0; i<m->num_marcos; i++)
+		if (dladdr(m->marcos[i], &info) && (info.dli_fname!=NULL) &&
+			es_programa(info.dli_fname, m->proc->imagen->prog))
+			return (char *)m->marcos[i]-(char *)info.dli_fbase;
+	return -1;
+}
+
+/*
+ * Toma una muestra de perfilado del proceso actual. La HAL no da acceso
+ * al contexto interrumpido, asi que se guardan sin resolver los marcos
+ * de la pila del manejador; el resto se hace en perfil_diferido, que ya
+ * no podria recorrerla porque el proceso ha seguido ejecutando.
+ *
+ * backtrace ejecuta en el manejador de la seal del reloj. Solo se
+ * llama si se interrumpio modo usuario, por lo que el nucleo no estaba
+ * dentro de malloc ni de dladdr, dl_iterate_phdr o la carga de una
+ * imagen, que son lo unico que comparte con el desenrollador; y la unica
+ * reserva de memoria de este, la carga de libgcc_s en la primera
+ * llamada, se hace en main antes de arrancar ningun proceso.
+ */
+static void muestrear_perfil(){
+	struct muestra_perfil *m;
+
+	if (num_muestras_perfil==MAX_MUESTRAS_PERFIL)
+		return;
+	m=&muestras_perfil[num_muestras_perfil++];
+	m->proc=p_proc_actual;
+	m->num_marcos=backtrace(m->marcos, MAX_MARCOS_PERFIL);
+	activar_sirq(SIRQ_PERFIL);
+}
+
+/*
+ * Anota una muestra en el histograma de perfilado de su proceso, si
+ * sigue vivo y perfilando. Las muestras fuera del rango cubierto por el
+ * histograma se descartan.
+ */
+static void anotar_muestra(struct muestra_perfil *m){
+	BCP *p_proc=m->proc;
+	long desp;
+	long celda;
+
+	if ((p_proc->perfil==NULL) || (p_proc->estado==NO_USADA) ||
+		(p_proc->estado==ZOMBI))
+		return;
+	if ((desp=pc_usuario(m))<0)
+		return;
+	celda=desp/p_proc->escala_perfil;
+	if (celda<p_proc->tam_perfil)
+		p_proc->perfil[celda]++;
+}
+
+/*
+ * Parte diferida del perfilado: resuelve las muestras que ha tomado la
+ * interrupcion de reloj. Se sacan todas de una vez con el reloj
+ * enmascarado para que pueda seguir anotando mientras se tratan.
+ */
+static void perfil_diferido(){
+	struct muestra_perfil muestras[MAX_MUESTRAS_PERFIL];
+	int n, i;
+	int nivel;
+
+	nivel=fijar_nivel_int(NIVEL_RELOJ);
+	n=num_muestras_perfil;
+	memcpy(muestras, muestras_perfil, n*sizeof(struct muestra_perfil));
+	num_muestras_perfil=0;
+	fijar_nivel_int(nivel);
+
+	for (i=0; i<n; i++)
+		anotar_muestra(&muestras[i]);
+}
+
+/*
+ * Actualiza las medias exponenciales del numero de procesos listos,
+ * en coma fija con FIJO_1 como unidad.
+ */
+static void actualizar_cargas(){
+	static const int factores[3]={EXP_1, EXP_5, EXP_15};
+	int activos=num_listos()*FIJO_1;
+	int i;
+
+	for (i=0; i<3; i++)
+		estadisticas.carga[i]=(estadisticas.carga[i]*factores[i] +
+			activos*(FIJO_1-factores[i])) / FIJO_1;
+}
+
+/*
+ * Descuenta un tick a los procesos bloqueados con plazo y desbloquea,
+ * sacandolos de la lista en la que esperan, aquellos cuyo plazo vence.
+ */
+static void vencer_plazos(){
+	BCP *p_proc;
+	int i;
+
+	for (i=0; i<MAX_PROC; i++) {
+		p_proc=&(tabla_procs[i]);
+		if ((p_proc->estado==BLOQUEADO) && (p_proc->plazo>0) &&
+			(--p_proc->plazo==0)) {
+			num_con_plazo--;
+			p_proc->plazo_vencido=1;
+			eliminar_elem(p_proc->lista_bloqueo, p_proc);
+			p_proc->estado=LISTO;
+			encolar_listo(p_proc);
+		}
+	}
+}
+
+/*
+ * Crea las pginas de informacin. Se reserva una regin annima que
+ * se proyecta dos veces, para escritura en el ncleo y solo para
+ * lectura en la direccin que se entrega a los procesos, de forma que
+ * un proceso que escribe en ella provoca una excepcin de memoria.
+ */
+static void iniciar_paginas_info(){
+	size_t tam=MAX_PROC*sizeof(struct pagina_info);
+	int fd;
+
+	fd=memfd_create("pagina_info", 0);
+	if ((fd<0) || (ftruncate(fd, tam)<0))
+		panico("no se pueden crear las paginas de informacion");
+	paginas_info=mmap(NULL, tam, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+	paginas_info_usuario=mmap(NULL, tam, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if ((paginas_info==MAP_FAILED) || (paginas_info_usuario==MAP_FAILED))
+		panico("no se pueden proyectar las paginas de informacion");
+	reloj_arranque=leer_reloj_CMOS();
+}
+
+/*
+ * Rellena la pgina de informacin de un proceso o hilo nuevo.
+ */
+static void iniciar_pagina_info(BCP *p_proc){
+	struct pagina_info *pag=&paginas_info[p_proc-tabla_procs];
+
+	pag->secuencia++;
+	__sync_synchronize();
+	pag->id=p_proc->id;
+	pag->ticks=ticks_arranque;
+	pag->reloj_base=reloj_arranque;
+	pag->ticks_por_seg=TICK;
+	pag->usuario=0;
+	pag->sistema=0;
+	__sync_synchronize();
+	pag->secuencia++;
+}
+
+/*
+ * Publica el tick en las pginas de todos los procesos existentes y
+ * los tiempos del proceso actual en la suya. El proceso ocioso no
+ * tiene pgina.
+ */
+static void actualizar_paginas_info(){
+	struct pagina_info *pag;
+	int i;
+
+	for (i=0; i<MAX_PROC; i++) {
+		if (tabla_procs[i].estado==NO_USADA)
+			continue;
+		pag=&paginas_info[i];
+		pag->secuencia++;
+		__sync_synchronize();
+		pag->ticks=ticks_arranque;
+		if (&tabla_procs[i]==p_proc_actual) {
+			pag->usuario=p_proc_actual->usuario;
+			pag->sistema=p_proc_actual->sistema;
+		}
+		__sync_synchronize();
+		pag->secuencia++;
+	}
+}
+
+/*
+ * Ejecuta las rutinas diferidas pendientes, en orden de numero. La
+ * llama el tratamiento de la interrupcion software y, como esta no
+ * llega a NIVEL_1, tambien el proceso ocioso tras cada espera.
+ */
+static void ejecutar_sirq(){
+	unsigned int pendientes;
+	int nivel;
+
+	/* se repite por si llega trabajo nuevo mientras se ejecuta */
+	for (;;) {
+		nivel=fijar_nivel_int(NIVEL_RELOJ);
+		pendientes=sirq_pendientes;
+		sirq_pendientes=0;
+		fijar_nivel_int(nivel);
+		if (pendientes==0)
+			break;
+		while (pendientes!=0) {
+			tabla_sirq[__builtin_ctz(pendientes)]();
+			pendientes&=(pendientes-1);
+		}
+	}
+}
+
+/*
+ * Marca como pendiente la interrupcion software diferida n y activa la
+ * interrupcion software, que la ejecutara al bajar el nivel.
+ */
+static void activar_sirq(int n){
+	int nivel;
+
+	nivel=fijar_nivel_int(NIVEL_RELOJ);
+	sirq_pendientes|=(1U<<n);
+	fijar_nivel_int(nivel);
+	activar_int_SW();
+}
+
+/*
+ * Descuenta un tick a los procesos dormidos y pasa a listos aquellos
+ * cuyo tiempo se agota.
+ */
+static void despertar_dormidos(){
+	BCP *p_proc;
+	BCP *p_sig;
+
+	for (p_proc=dormidos.primero; p_proc!=NULL; p_proc=p_sig) {
+		/* se guarda antes, ya que desbloquear lo cambia */
+		p_sig=p_proc->siguiente;
+		if ((p_proc->segs==0) || (--p_proc->segs==0))
+			desbloquear_elem(&dormidos, p_proc);
+	}
+}
+
+/*
+ * Parte diferida del tratamiento del reloj: trata los ticks que han
+ * llegado desde la ultima vez, que pueden ser varios si la interrupcion
+ * software se ha retrasado.
+ */
+static void reloj_diferido(){
+	int nivel;
+	int n;
+
+	nivel=fijar_nivel_int(NIVEL_RELOJ);
+	n=ticks_diferidos;
+	ticks_diferidos=0;
+	fijar_nivel_int(nivel);
+
+	while (n-- > 0) {
+		/* cargas medias, recalculadas cada segundo */
+		if (++ticks_tratados % TICK == 0)
+			actualizar_cargas();
+
+		/* Tratamos los procesos bloqueados con plazo */
+		if(num_con_plazo > 0)
+			vencer_plazos();
+
+		/* Tratamos los procesos dormidos */
+		if(dormidos.primero != NULL)
+			despertar_dormidos();
+	}
+
+	/* pagina de informacion que leen los procesos sin llamadas */
+	actualizar_paginas_info();
+}
+
+/*
+ * Tratamiento de interrupciones de reloj. Solo hace la contabilidad
+ * que depende del proceso interrumpido; el resto se difiere.
  */
 static void int_reloj(){
 
+	/* el tratamiento se ejecuta con todo enmascarado */
+	empezar_enmascarado(__func__, __LINE__);
 	printk("-> TRATANDO INT. DE RELOJ\n");
 
 	/* parte asociada a tiempos_proceso */
 	num_ints_desde_arranque++;
-	// Asignamos recursos de procesador si hay alguno que 
-	// lo necesite
-	if(lista_listos.primero != NULL) {
+	ticks_arranque++;
+	// Asignamos el tick al proceso actual; el proceso ocioso
+	// siempre ejecuta en modo sistema
+	if(p_proc_actual != NULL) {
 		if(viene_de_modo_usuario()){
 			p_proc_actual->usuario++;
+			estadisticas.ticks_usuario++;
 		}
 		else {
 			p_proc_actual->sistema++;
+			if(p_proc_actual == &bcp_ocioso)
+				estadisticas.ticks_ocioso++;
+			else
+				estadisticas.ticks_sistema++;
 		}
         
 	}
 
-	/* Tratamos los procesos dormidos */
-	if(dormidos.primero != NULL) {
-		BCP * pr_dormido;
-		BCP * dorm_aux;
-
-		pr_dormido = dormidos.primero;
-		while(pr_dormido != NULL) {
-			pr_dormido->segs--;
-			// Si algun proceso terminado su espera
-			if(pr_dormido->segs <= 0) {
-				//reajustamos listas
-				pr_dormido->estado = LISTO;
-
-				if(pr_dormido->siguiente != NULL) {
-					// El puntero interno se modifica
-					// Guardamos una copia antes para mantener el orden
-					dorm_aux = pr_dormido->siguiente;
-					eliminar_elem(&dormidos, pr_dormido);
-					insertar_ultimo(&lista_listos, pr_dormido);
-					pr_dormido = dorm_aux;
-				}
-				else {
-					eliminar_elem(&dormidos, pr_dormido);
-					insertar_ultimo(&lista_listos, pr_dormido);
-				}
-
-				pr_dormido = pr_dormido->siguiente;
-
-			}
-		}
-	}
-
-	/* Si hay algun proceso en estado de listo lo tratamos */
-	if(lista_listos.primero != NULL) {
+	/* perfilado estadistico del proceso interrumpido */
+	if((p_proc_actual != NULL) && (p_proc_actual->perfil != NULL) &&
+		viene_de_modo_usuario())
+		muestrear_perfil();
 
-	}
+	ticks_diferidos++;
+	activar_sirq(SIRQ_RELOJ);
 
+	terminar_enmascarado();
 	return;
 }
 
+/*
+ * Devuelve el argumento n (de 1 a MAX_ARGS_LLAMADA) de la llamada en
+ * curso, que tratar_llamsis ha copiado de los registros al BCP.
+ */
+static long leer_argumento(int n){
+	return p_proc_actual->args[n-1];
+}
+
 /*
  * Tratamiento de llamadas al sistema
  */
 static void tratar_llamsis(){
-	int nserv, res;
-
-	nserv=leer_registro(0);
-	if (nserv<NSERVICIOS)
+	unsigned int nserv;
+	int n, res;
+
+	/* al ser sin signo, los numeros negativos tambien quedan fuera */
+	nserv=(unsigned int)leer_registro(0);
+	estadisticas.llamadas++;
+	if (nserv<NSERVICIOS) {
+		/* solo se leen los registros que usa la llamada */
+		for (n=0; n<tabla_servicios[nserv].nargs; n++)
+			p_proc_actual->args[n]=leer_registro(n+1);
 		res=(tabla_servicios[nserv].fservicio)();
+	}
 	else
 		res=-1;		/* servicio no existente */
 	escribir_registro(0,res);
@@ -389,59 +1316,249 @@ static void int_sw(){
 
 	printk("-> TRATANDO INT. SW\n");
 
+	ejecutar_sirq();
 	return;
 }
 
 /*
- *
- * Funcion auxiliar que crea un proceso reservando sus recursos.
- * Usada por llamada crear_proceso.
- *
+ * Funcion auxiliar que busca una entrada libre en la tabla de imagenes.
+ * Siempre hay alguna, ya que hay tantas entradas como BCPs.
  */
-static int crear_tarea(char *prog){
-	void * imagen, *pc_inicial;
-	int error=0;
-	int proc;
-	BCP *p_proc;
-	int n;
+static tipo_imagen * buscar_imagen_libre(){
+	int i;
 
-	proc=buscar_BCP_libre();
-	if (proc==-1)
-		return -1;	/* no hay entrada libre */
+	for (i=0; (i<MAX_PROC) && (imagenes[i].num_hilos>0); i++);
+	return &(imagenes[i]);
+}
 
-	/* A rellenar el BCP ... */
-	p_proc=&(tabla_procs[proc]);
+/*
+ * Funcion auxiliar para dl_iterate_phdr que, al encontrar la imagen
+ * buscada, cuenta las paginas de sus segmentos y las residentes o, si
+ * se pide precargarla, las toca todas. tam es el de la estructura que
+ * pasa la biblioteca, que debe llegar al menos hasta dlpi_phnum.
+ * Return: 1 si era la imagen buscada, lo que termina el recorrido
+ */
+static int recorrer_segmentos(struct dl_phdr_info *info, size_t tam,
+				void *dato){
+	struct recorrido_imagen *r=dato;
+	unsigned char residente[PAGINAS_MINCORE];
+	long tam_pag=sysconf(_SC_PAGESIZE);
+	const ElfW(Phdr) *seg;
+	char *inicio, *fin;
+	long n, k, j;
+	int i;
 
-	/* crea la imagen de memoria leyendo ejecutable */
-	imagen=crear_imagen(prog, &pc_inicial);
-	if (imagen)
-	{
-		p_proc->info_mem=imagen;
-		p_proc->pila=crear_pila(TAM_PILA);
-		fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
-			pc_inicial,
-			&(p_proc->contexto_regs));
-		p_proc->id=proc;
-		p_proc->estado=LISTO;
+	if (tam<offsetof(struct dl_phdr_info, dlpi_phnum)+
+			sizeof(info->dlpi_phnum))
+		return 1;
+	if (info->dlpi_addr!=r->base)
+		return 0;
+	for (i=0; i<info->dlpi_phnum; i++) {
+		seg=&info->dlpi_phdr[i];
+		if (seg->p_type!=PT_LOAD)
+			continue;
+		inicio=(char *)((info->dlpi_addr+seg->p_vaddr) & ~(tam_pag-1));
+		fin=(char *)(info->dlpi_addr+seg->p_vaddr+seg->p_memsz);
+		n=(fin-inicio+tam_pag-1)/tam_pag;
+		r->paginas+=n;
+		for (; n>0; n-=k, inicio+=k*tam_pag) {
+			k=(n<PAGINAS_MINCORE) ? n : PAGINAS_MINCORE;
+			if (r->precargar) {
+				for (j=0; j<k; j++)
+					(void)*(volatile char *)(inicio+j*tam_pag);
+				continue;
+			}
+			if (mincore(inicio, k*tam_pag, residente)<0)
+				break;
+			for (j=0; j<k; j++)
+				r->residentes+=(residente[j] & 1);
+		}
+	}
+	return 1;
+}
+
+/*
+ * Recorre los segmentos de una imagen: los cuenta o los precarga
+ */
+static void recorrer_imagen(tipo_imagen *imagen, struct recorrido_imagen *r,
+				int precargar){
+	r->base=imagen->base_carga;
+	r->precargar=precargar;
+	r->paginas=0;
+	r->residentes=0;
+	if (imagen->base_carga!=0)
+		dl_iterate_phdr(recorrer_segmentos, r);
+}
+
+/*
+ * Obtiene el desplazamiento de carga del ejecutable que contiene la
+ * direccion indicada, que identifica la imagen aunque haya varias del
+ * mismo programa.
+ * Return: el desplazamiento; 0 si no se encuentra
+ */
+static unsigned long base_de_carga(void *dir){
+	struct link_map *objeto;
+	Dl_info info;
+
+	if (!dladdr1(dir, &info, (void **)&objeto, RTLD_DL_LINKMAP) ||
+		(objeto==NULL))
+		return 0;
+	return objeto->l_addr;
+}
+
+/*
+ * Obtiene el punto de entrada de un proceso nuevo. Si el ejecutable
+ * incluye la rutina de biblioteca inicio_proceso, el proceso arranca en
+ * ella, que obtiene main con datos_hilo y termina con el valor que
+ * devuelva; si no, arranca donde indica la HAL y termina con estado 0.
+ */
+static void *entrada_proceso(BCP *p_proc, void *pc_inicial){
+	struct link_map *objeto;
+	Dl_info info;
+	void *inicio, *principal;
+
+	p_proc->funcion_hilo=NULL;
+	p_proc->arg_hilo=NULL;
+	if (!dladdr1(pc_inicial, &info, (void **)&objeto, RTLD_DL_LINKMAP) ||
+		(objeto==NULL))
+		return pc_inicial;
+	inicio=dlsym(objeto, "inicio_proceso");
+	principal=dlsym(objeto, "main");
+	if ((inicio==NULL) || (principal==NULL))
+		return pc_inicial;
+	p_proc->funcion_hilo=principal;
+	return inicio;
+}
+
+/*
+ * Funcion auxiliar que rellena el BCP de un proceso o hilo nuevo que
+ * ejecuta sobre la imagen indicada, sin insertarlo todavia en la cola
+ * de listos.
+ */
+static void preparar_tarea(BCP *p_proc, int proc, tipo_imagen *imagen,
+				void *pc_inicial){
+	imagen->num_hilos++;
+	p_proc->imagen=imagen;
+	p_proc->info_mem=imagen->info_mem;
+	p_proc->pila=crear_pila(TAM_PILA);
+	fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
+		pc_inicial,
+		&(p_proc->contexto_regs));
+	p_proc->id=proc;
+	p_proc->estado=LISTO;
+
+	p_proc->usuario = 0;
+	p_proc->sistema = 0;
+	p_proc->replanificacion = 0;
+	p_proc->perfil = NULL;
+	p_proc->plazo = 0;
+	p_proc->mutex_cedido = 0;
+	p_proc->esperando_fin.primero = NULL;
+	p_proc->esperando_fin.ultimo = NULL;
+	memset(p_proc->mapa_descriptores, 0,
+		PALABRAS_MAPA(num_desc_proc) * sizeof(unsigned int));
+	iniciar_pagina_info(p_proc);
+}
+
+/*
+ * Funcion auxiliar que prepara un proceso o hilo nuevo y lo inserta
+ * al final de la cola de listos. Usada por crear_hilo.
+ */
+static void iniciar_tarea(BCP *p_proc, int proc, tipo_imagen *imagen,
+				void *pc_inicial){
+	int nivel;
+
+	preparar_tarea(p_proc, proc, imagen, pc_inicial);
+
+	/* lo inserta al final de cola de listos */
+	nivel = fijar_nivel_int(NIVEL_LISTAS);
+	encolar_listo(p_proc);
+	fijar_nivel_int(nivel);
+}
+
+/*
+ *
+ * Funcion auxiliar que crea n procesos que ejecutan el mismo programa.
+ * Reserva primero todos los BCPs e imagenes, de forma que si falta
+ * alguno no se crea ninguno, y despues los inserta en la cola de
+ * listos dentro de una unica seccion critica.
+ * Usada por las llamadas crear_proceso y crear_procesos.
+ * Return: 0 si exito; -1 si error
+ *
+ */
+static int crear_tareas(char *prog, int n, int *pids){
+	BCP *procs[MAX_PROC];
+	void *mapas[MAX_PROC];
+	void *pcs[MAX_PROC];
+	tipo_imagen *p_imagen;
+	struct recorrido_imagen recorrido;
+	int i, j;
+	int nivel;
 
-		p_proc->usuario = 0;
-		p_proc->sistema = 0;
-		p_proc->replanificacion = 0;
+	if ((n<=0) || (n>MAX_PROC))
+		return -1;
 
-		for(n=0; n < NUM_MUT_PROC; n++) {
-			p_proc->descriptores[n].libre = 0;
+	/* reserva de BCPs */
+	for (i=0, j=0; (i<MAX_PROC) && (j<n); i++)
+		if (tabla_procs[i].estado==NO_USADA)
+			procs[j++]=&(tabla_procs[i]);
+	if (j<n)
+		return -1;	/* no hay entradas libres */
+
+	/* crea las imagenes de memoria leyendo ejecutable; la HAL no
+	   permite duplicar un mapa, por lo que cada proceso carga el suyo */
+	for (j=0; j<n; j++) {
+		mapas[j]=crear_imagen(prog, &pcs[j]);
+		if ((mapas[j]==NULL) && (num_pendientes>0)) {
+			/* puede faltar memoria: se recupera la pendiente */
+			recoger_pendientes();
+			mapas[j]=crear_imagen(prog, &pcs[j]);
+		}
+		if (mapas[j]==NULL) {
+			while (j>0)
+				liberar_imagen(mapas[--j]);
+			return -1; /* fallo al crear imagen */
 		}
+	}
 
-		/* lo inserta al final de cola de listos */
-		nivel_previo = fijar_nivel_int(NIVEL_3);
-		insertar_ultimo(&lista_listos, p_proc);
-		fijar_nivel_int(nivel_previo);
-		error= 0;
+	/* A rellenar los BCPs ... */
+	for (j=0; j<n; j++) {
+		p_imagen=buscar_imagen_libre();
+		p_imagen->info_mem=mapas[j];
+		strncpy(p_imagen->prog, prog, MAX_NOM_PROG);
+		p_imagen->prog[MAX_NOM_PROG]='\0';
+		p_imagen->base_carga=base_de_carga(pcs[j]);
+		if (!CARGA_BAJO_DEMANDA)
+			recorrer_imagen(p_imagen, &recorrido, 1);
+		procs[j]->es_hilo=0;
+		/* el proceso inicial no tiene padre */
+		procs[j]->padre=(p_proc_actual ? p_proc_actual->id : -1);
+		preparar_tarea(procs[j], procs[j]-tabla_procs, p_imagen,
+			entrada_proceso(procs[j], pcs[j]));
 	}
-	else
-		error= -1; /* fallo al crear imagen */
 
-	return error;
+	/* los inserta al final de cola de listos */
+	nivel = fijar_nivel_int(NIVEL_LISTAS);
+	for (j=0; j<n; j++)
+		encolar_listo(procs[j]);
+	fijar_nivel_int(nivel);
+
+	for (j=0; j<n; j++)
+		pids[j]=procs[j]->id;
+	estadisticas.procesos_creados+=n;
+	return 0;
+}
+
+/*
+ * Funcion auxiliar que crea un proceso reservando sus recursos.
+ * Return: identificador del proceso o -1 si error
+ */
+static int crear_tarea(char *prog){
+	int proc;
+
+	if (crear_tareas(prog, 1, &proc)<0)
+		return -1;
+	return proc;
 }
 
 /*
@@ -465,30 +1582,34 @@ static int crear_tarea(char *prog){
  */
  int sis_dormir() {
  	BCP * p_proc_anterior;
+ 	int nivel;
+ 	nivel = fijar_nivel_int(NIVEL_LISTAS);
  	// Ponemos el estado a bloqueado y
  	// leemos el num de segs del registro 1
  	p_proc_actual->estado = BLOQUEADO;
- 	p_proc_actual->segs = leer_registro(1)*TICK;
+ 	p_proc_actual->segs = leer_argumento(1)*TICK;
  	// indicamos que ya no es necesario realizar
  	// cambio de contexto involuntario
  	p_proc_actual->replanificacion = 0;
- 	nivel_previo = fijar_nivel_int(NIVEL_3);
  	// Eliminamos de la lista de procesos listos 
  	// e insertamos en la lista de dormidos
- 	eliminar_primero(&lista_listos);
+ 	sacar_listo(p_proc_actual);
  	insertar_ultimo(&dormidos, p_proc_actual);
+ 	p_proc_actual->lista_bloqueo = &dormidos;
  	// hacemos un cambio de contexto
+ 	fijar_nivel_int(NIVEL_CAMBIO);
  	p_proc_anterior = p_proc_actual;
  	p_proc_actual = planificador();
 
  	printk("*** CAMBIO CONTEXTO DORMIR: de %d hasta %d\n",
  		p_proc_anterior->id, p_proc_actual->id);
+ 	estadisticas.cambios[CAMBIO_DORMIR]++;
 
  	// Restauramos el contexto de nuestro nuevo proc_actual
  	cambio_contexto(&(p_proc_anterior->contexto_regs),
  	 &(p_proc_actual->contexto_regs));
  	//fijamos nivel previo de interrupciones
- 	fijar_nivel_int(nivel_previo);
+ 	fijar_nivel_int(nivel);
  	return 0;
  } 
 
@@ -498,18 +1619,34 @@ static int crear_tarea(char *prog){
  */
  int sis_tiempos_proceso() {
  	struct tiempos_ejec *t_ejec;
- 	t_ejec = (struct tiempos_ejec *)leer_registro(1);
+ 	int nivel;
+ 	t_ejec = (struct tiempos_ejec *)leer_argumento(1);
  	
  	if(t_ejec != NULL ) {
- 		nivel_previo = fijar_nivel_int(3);
+ 		nivel = fijar_nivel_int(NIVEL_RELOJ);
  		t_ejec->usuario = p_proc_actual->usuario;
  		t_ejec->sistema = p_proc_actual->sistema;
  		accede = 1;
- 		fijar_nivel_int(nivel_previo);
+ 		fijar_nivel_int(nivel);
  	}
  	return num_ints_desde_arranque;
  }
 
+/*
+ * Tratamiento de la llamada al sistema obtener_pagina_info. Devuelve en
+ * dir la direccin, de solo lectura, de la pgina de informacin del
+ * proceso que llama.
+ */
+int sis_obtener_pagina_info() {
+	const struct pagina_info **dir =
+		(const struct pagina_info **)leer_argumento(1);
+
+	if (dir == NULL)
+		return -1;
+	*dir = &paginas_info_usuario[p_proc_actual - tabla_procs];
+	return 0;
+}
+
 
  /*
  * Comienza la parte de MUTEX
@@ -517,16 +1654,17 @@ static int crear_tarea(char *prog){
 
  /*
  *	Tratamiento de la llamada al sistema crear_mutex. Llama
- *  a las funciones auxiliares mutex_exist, existe_descriptor y 
+ *  a las funciones auxiliares buscar_nombre, existe_descriptor y 
  *	dame_libre.
  */
  int sis_crear_mutex() {
  	BCP * p_proc_anterior;
- 	char*nombre = (char*)leer_registro(1);
+ 	char*nombre = (char*)leer_argumento(1);
  	int pos;
  	int exists;
  	int disponibilidad;
- 	int type = leer_registro(2);
+ 	int type = leer_argumento(2);
+ 	int nivel;
 
  	// Vemos si hay descriptor libres
  	pos = existe_descriptor();
@@ -538,7 +1676,7 @@ static int crear_tarea(char *prog){
  	}
 
  	// en cualquier otro caso:
- 	exists = mutex_exist(nombre);
+ 	exists = (buscar_nombre(OBJ_MUTEX, nombre) >= 0);
 
  	if(exists) {
  		printk("ERROR: ya existe el MUTEX");
@@ -550,44 +1688,64 @@ static int crear_tarea(char *prog){
 
  	// Si no hay huecos, se bloquea
  	while(disponibilidad == LLENO) {
+ 		nivel = fijar_nivel_int(NIVEL_LISTAS);
  		p_proc_actual->estado = BLOQUEADO;
  		p_proc_actual->replanificacion = 0;
- 		nivel_previo = fijar_nivel_int(NIVEL_3);
- 		eliminar_primero(&lista_listos);
+ 		sacar_listo(p_proc_actual);
  		// Lo insertamos al final de la lista
  		insertar_ultimo(&lista_de_mutex, p_proc_actual);
+ 		p_proc_actual->lista_bloqueo = &lista_de_mutex;
  		// Hacemos un c. de contexto
+ 		fijar_nivel_int(NIVEL_CAMBIO);
  		p_proc_anterior = p_proc_actual;
  		//Esperamos a que haya un proceso listo
  		p_proc_actual = planificador();
  		//Imprimimos:
  		printk("*** CAMBIO CONTEXTO POR FUNCION CREAR MUTEX: de %d a %d\n",
  			p_proc_anterior->id, p_proc_actual->id);
+ 		estadisticas.cambios[CAMBIO_MUTEX]++;
  		// Restauramos contexto del nuevo proceso actual
  		cambio_contexto(&(p_proc_anterior->contexto_regs),
  			&(p_proc_actual->contexto_regs));
- 		fijar_nivel_int(nivel_previo);
+ 		fijar_nivel_int(nivel);
+ 		creadores_despertados--;
  		disponibilidad = dame_libre();
  	}
  	// En cualquier otro caso comprobamos:
- 	// Si existe ya un mutex con dicho nombre
- 	exists = mutex_exist(nombre);
+ 	// Si existe ya un mutex con dicho nombre. En los errores que siguen
+ 	// el hueco queda libre y puede aprovecharlo otro proceso bloqueado
+ 	exists = (buscar_nombre(OBJ_MUTEX, nombre) >= 0);
 
  	if(exists) {
  		printk("ERROR: ya existe el mutex");
+ 		despertar_creadores();
+ 		return -1;
+ 	}
+
+ 	mutex[disponibilidad] = reservar_objeto(cache_mutex);
+ 	if(mutex[disponibilidad] == NULL) {
+ 		printk("ERROR: no queda memoria para el MUTEX\n");
+ 		despertar_creadores();
+ 		return -1;
+ 	}
+ 	if(registrar_nombre(OBJ_MUTEX, nombre, disponibilidad) < 0) {
+ 		printk("ERROR: nombre de MUTEX no valido\n");
+ 		liberar_objeto(cache_mutex, mutex[disponibilidad]);
+ 		mutex[disponibilidad] = NULL;
+ 		despertar_creadores();
  		return -1;
  	}
 
  	//Tras las verificaciones
  	//Creamos el MUTEX:
- 	mutex[disponibilidad].propietario = p_proc_actual->id;
- 	mutex[disponibilidad].num_procs_en_mutex++;
- 	mutex[disponibilidad].tipo = type;
- 	mutex[disponibilidad].nombre_mutex = strdup(nombre);
+ 	mutex[disponibilidad]->propietario = p_proc_actual->id;
+ 	mutex[disponibilidad]->num_procs_en_mutex++;
+ 	mutex[disponibilidad]->tipo = type;
+ 	mutex[disponibilidad]->modo = MODO_COMPETENCIA;
+ 	memset(&mutex[disponibilidad]->contencion, 0,
+ 		sizeof(struct contencion_mutex));
 
- 	p_proc_actual->descriptores[pos].descript = disponibilidad;
- 	p_proc_actual->descriptores[pos].libre = 1;
- 	return disponibilidad;
+ 	return ocupar_descriptor(pos, OBJ_MUTEX, disponibilidad);
 
  }
 
@@ -596,9 +1754,8 @@ static int crear_tarea(char *prog){
  *	auxiliares 
  */
 int sis_abrir_mutex() {
-	char*nombre = (char*)leer_registro(1);
+	char*nombre = (char*)leer_argumento(1);
  	int pos;
- 	int exists;
  	int descriptor;
 
  	pos = existe_descriptor();
@@ -610,96 +1767,204 @@ int sis_abrir_mutex() {
  	}
 
  	// Si no se cumple lo anterior:
- 	exists = mutex_exist(nombre);
+ 	descriptor = buscar_nombre(OBJ_MUTEX, nombre);
  	//Si no existe:
- 	if (!exists) {
+ 	if (descriptor < 0) {
  		printk("ERROR: no existe el MUTEX en el sistema operativo\n");
  		return -1;
  	}
 
  	// Si hemos llegado hasta aqui se han cumplido las precondiciones
  	// Por lo que concedemos el descriptor al mutex
- 	descriptor = dame_posicion_en_mutex(nombre);
- 	mutex[descriptor].num_procs_en_mutex++;
- 	p_proc_actual->descriptores[pos].descript = descriptor;
- 	p_proc_actual->descriptores[pos].libre = 1;
+ 	mutex[descriptor]->num_procs_en_mutex++;
+ 	return ocupar_descriptor(pos, OBJ_MUTEX, descriptor);
+}
+
+/*
+ *	Funcion auxiliar que actualiza los contadores de contencion de un
+ *	mutex recien adquirido. inicio_espera es el tick en que el proceso
+ *	empezo a esperar, o -1 si lo obtuvo sin bloquearse.
+ */
+static void anotar_adquisicion(unsigned int mutexid, int inicio_espera) {
+	tipo_mutex *m = mutex[mutexid];
+	int espera;
+
+	m->contencion.adquisiciones++;
+	if(m->bloqueado == 1)
+		m->inicio_retencion = num_ints_desde_arranque;
+	if(m->bloqueado > m->contencion.profundidad_max)
+		m->contencion.profundidad_max = m->bloqueado;
+	if(inicio_espera >= 0) {
+		espera = num_ints_desde_arranque - inicio_espera;
+		m->contencion.contendidas++;
+		m->contencion.espera_total += espera;
+		if(espera > m->contencion.espera_max)
+			m->contencion.espera_max = espera;
+	}
+}
+
+/*
+ *	Funcion auxiliar que anota el tiempo de retencion de un mutex que
+ *	acaba de quedar libre.
+ */
+static void anotar_liberacion(unsigned int mutexid) {
+	tipo_mutex *m = mutex[mutexid];
+	int retencion = num_ints_desde_arranque - m->inicio_retencion;
 
- 	return descriptor;
+	m->contencion.retencion_total += retencion;
+	if(retencion > m->contencion.retencion_max)
+		m->contencion.retencion_max = retencion;
 }
 
-int sis_lock() {
+/*
+ *	Funcion auxiliar que comprueba si el proceso actual puede bloquearse
+ *	en un mutex segun la espera pedida (-1 sin limite, 0 ninguna, o un
+ *	numero de ticks) y, si hay plazo, lo pone en marcha. Se llama con
+ *	el nivel ya en NIVEL_LISTAS, ya que vencer_plazos usa num_con_plazo.
+ *	Return: 0 si puede bloquearse; -1 si no debe esperar
+ */
+static int iniciar_plazo(int espera) {
+	if(espera == 0)
+		return -1;
+	if((espera > 0) && (p_proc_actual->plazo == 0)) {
+		p_proc_actual->plazo = espera;
+		num_con_plazo++;
+	}
+	return 0;
+}
+
+/*
+ *	Funcion auxiliar que anula el plazo pendiente del proceso actual
+ */
+static void cancelar_plazo() {
+	int nivel;
+
+	nivel = fijar_nivel_int(NIVEL_LISTAS);
+	if(p_proc_actual->plazo > 0) {
+		p_proc_actual->plazo = 0;
+		num_con_plazo--;
+	}
+	fijar_nivel_int(nivel);
+}
+
+/*
+ *	Funcion auxiliar que intenta adquirir el mutex indicado esperando
+ *	como mucho lo indicado por espera. Usada por lock_mutex.
+ */
+static int adquirir_mutex(unsigned int mutexid, int espera) {
 	BCP*p_proc_anterior;
 	int blocked;
-	unsigned int mutexid = (unsigned int)leer_registro(1);
+	int inicio_espera = -1;
+	int nivel;
+
+	if(mutexid >= (unsigned int)num_mut) {
+		printk("ERROR: descriptor de mutex no valido\n");
+		return -1;
+	}
 
 	do {
 		blocked = 0;
-		if(mutex[mutexid].num_procs_en_mutex > 0) {
+		if((mutex[mutexid] != NULL) && (mutex[mutexid]->num_procs_en_mutex > 0)) {
 			//Verificamos si esta o no esta bloqueado
-			if(mutex[mutexid].bloqueado > 0) {
+			if(mutex[mutexid]->bloqueado > 0) {
 				//Comprobamos si es RECURSIVO
-				if(mutex[mutexid].tipo == RECURSIVO) {
+				if(mutex[mutexid]->tipo == RECURSIVO) {
 					//Comprobamos si es el dueo
-					if(mutex[mutexid].propietario == p_proc_actual->id) {
+					if(mutex[mutexid]->propietario == p_proc_actual->id) {
 						//Aumentamos el numero de bloqueos en el mutex
-						mutex[mutexid].bloqueado++;
+						mutex[mutexid]->bloqueado++;
+						anotar_adquisicion(mutexid, inicio_espera);
 					}
 					// Si no, bloqueamos al proceso
 					else {
+						// el plazo y el estado se fijan ya con el nivel
+						// subido para que vencer_plazos no los vea a medias
+						nivel = fijar_nivel_int(NIVEL_LISTAS);
+						if(iniciar_plazo(espera) < 0) {
+							fijar_nivel_int(nivel);
+							return -1;
+						}
+						if(inicio_espera < 0)
+							inicio_espera = num_ints_desde_arranque;
 						p_proc_actual->estado = BLOQUEADO;
 						// Ya no se debe hacer C. de contexto involuntario
 						p_proc_actual->replanificacion = 0;
-						nivel_previo = fijar_nivel_int(NIVEL_3);
 
-						eliminar_primero(&lista_listos);
+						sacar_listo(p_proc_actual);
 						//Lo insertamos en la lista de bloqueados por un lock
-						insertar_ultimo(&lista_de_bloqueados, p_proc_actual);
+						insertar_ultimo(&mutex[mutexid]->bloqueados, p_proc_actual);
+						p_proc_actual->lista_bloqueo = &mutex[mutexid]->bloqueados;
 						//Hacemos un C de Contexto
+						fijar_nivel_int(NIVEL_CAMBIO);
 						p_proc_anterior = p_proc_actual;
 						p_proc_actual = planificador();
 
 						printk("*** C de CONTEXTO POR UN LOCK: de %d a %d\n",
 						p_proc_anterior->id, p_proc_actual->id);
+						estadisticas.cambios[CAMBIO_MUTEX]++;
 						
 						//Restauramos el contexto del nuevo actual
 						cambio_contexto(&(p_proc_anterior->contexto_regs), &(p_proc_actual->contexto_regs));
-						fijar_nivel_int(nivel_previo);
+						fijar_nivel_int(nivel);
+						if(p_proc_actual->plazo_vencido)
+							return -1;
+						//Si se nos ha cedido ya somos los propietarios
+						if(p_proc_actual->mutex_cedido) {
+							anotar_adquisicion(mutexid, inicio_espera);
+							return 0;
+						}
 						//Ahora indicamos que hay que volver a comprobar para que no se 
 						//cuele ningun proceso
 						blocked = 1;
 					}
 				}
-				else if(mutex[mutexid].tipo == NO_RECURSIVO) {
+				else if(mutex[mutexid]->tipo == NO_RECURSIVO) {
 					//Vemos si es el dueo del bloqueo
-					if(mutex[mutexid].propietario == p_proc_actual->id) {
+					if(mutex[mutexid]->propietario == p_proc_actual->id) {
 						//Comprobamos si ya hay un proceso bloqueandolo
-						if(mutex[mutexid].propietario == p_proc_actual->id) {
+						if(mutex[mutexid]->propietario == p_proc_actual->id) {
 							//Si es asi, capturamos el error. Ya que se produciria interbloqueo
 							printk("ERROR: se esta produciendo un caso de interbloqueo trivial\n");
 							return -1;
 						}
 						//En caso contrario bloqueamos el mutex
-						mutex[mutexid].bloqueado++;
+						mutex[mutexid]->bloqueado++;
 					}
 					//Si no es el dueo bloqueamos al proceso
 					else {
+						nivel = fijar_nivel_int(NIVEL_LISTAS);
+						if(iniciar_plazo(espera) < 0) {
+							fijar_nivel_int(nivel);
+							return -1;
+						}
+						if(inicio_espera < 0)
+							inicio_espera = num_ints_desde_arranque;
 						p_proc_actual->estado = BLOQUEADO;
 						// Ya no es necesario hacer cambio de contexto involuntario
 						p_proc_actual->replanificacion = 0;
-						nivel_previo = fijar_nivel_int(NIVEL_3);
-						
-						eliminar_primero(&lista_listos);
-						insertar_ultimo(&lista_de_bloqueados, p_proc_actual);
+
+						sacar_listo(p_proc_actual);
+						insertar_ultimo(&mutex[mutexid]->bloqueados, p_proc_actual);
+						p_proc_actual->lista_bloqueo = &mutex[mutexid]->bloqueados;
 						//Hacemos un C de Contexto
+						fijar_nivel_int(NIVEL_CAMBIO);
 						p_proc_anterior = p_proc_actual;
 						p_proc_actual = planificador();
 
 						printk("*** C de CONTEXTO POR UN LOCK: de %d a %d\n",
 							p_proc_anterior->id, p_proc_actual->id);
+						estadisticas.cambios[CAMBIO_MUTEX]++;
 						//Restauramos el contexto del nuevo actual
 						cambio_contexto(&(p_proc_anterior->contexto_regs),
 							&(p_proc_actual->contexto_regs));
-						fijar_nivel_int(nivel_previo);
+						fijar_nivel_int(nivel);
+						if(p_proc_actual->plazo_vencido)
+							return -1;
+						//Si se nos ha cedido ya somos los propietarios
+						if(p_proc_actual->mutex_cedido) {
+							anotar_adquisicion(mutexid, inicio_espera);
+							return 0;
+						}
 
 						//Indamos que hay que volver a comprobar para que no se cuele
 						//ningun proceso
@@ -707,11 +1972,12 @@ int sis_lock() {
 					}
 				}
 			}
-			else if(mutex[mutexid].bloqueado == 0) {
+			else if(mutex[mutexid]->bloqueado == 0) {
 				//Hacemos que el proceso actual pase a ser el nuevo propietario
 				//Bloqueamos al mutex
-				mutex[mutexid].bloqueado++;
-				mutex[mutexid].propietario = p_proc_actual->id;
+				mutex[mutexid]->bloqueado++;
+				mutex[mutexid]->propietario = p_proc_actual->id;
+				anotar_adquisicion(mutexid, inicio_espera);
 			}
 			else {
 				printk("ERROR: error interno en el mutex");
@@ -727,31 +1993,117 @@ int sis_lock() {
 	return 0;
 }
 
-int sis_unlock() {
-	BCP*pr_bloqueado;
-	unsigned int mutex_id = (unsigned int)leer_registro(1);
+/*
+ *	Funcion auxiliar que bloquea el mutex indicado. espera es -1 para
+ *	esperar sin limite, 0 para no esperar o el plazo maximo en ticks.
+ *	Usada por las llamadas lock, trylock, lock_timeout y wait_cond.
+ *	Return: 0 si se adquiere; -1 si error, ocupado o plazo vencido
+ */
+static int lock_mutex(unsigned int mutexid, int espera) {
+	int res;
+
+	p_proc_actual->plazo_vencido = 0;
+	p_proc_actual->mutex_cedido = 0;
+	res = adquirir_mutex(mutexid, espera);
+	p_proc_actual->mutex_cedido = 0;
+	cancelar_plazo();
+	return res;
+}
+
+int sis_lock() {
+	int mutexid = objeto_descriptor(OBJ_MUTEX, (unsigned int)leer_argumento(1));
+
+	if (mutexid < 0) {
+		printk("ERROR: el proceso no tiene abierto el mutex\n");
+		return -1;
+	}
+
+	return lock_mutex(mutexid, -1);
+}
+
+/*
+ *	Tratamiento de la llamada al sistema trylock. Adquiere el mutex solo
+ *	si puede hacerlo sin bloquearse.
+ */
+int sis_trylock() {
+	int mutexid = objeto_descriptor(OBJ_MUTEX, (unsigned int)leer_argumento(1));
+
+	if (mutexid < 0) {
+		printk("ERROR: el proceso no tiene abierto el mutex\n");
+		return -1;
+	}
+
+	return lock_mutex(mutexid, 0);
+}
+
+/*
+ *	Tratamiento de la llamada al sistema lock_timeout. Espera por el
+ *	mutex como mucho los milisegundos indicados, redondeados a ticks.
+ */
+int sis_lock_timeout() {
+	int mutexid = objeto_descriptor(OBJ_MUTEX, (unsigned int)leer_argumento(1));
+	int ms = (int)leer_argumento(2);
+	long long ticks;
+
+	if (mutexid < 0) {
+		printk("ERROR: el proceso no tiene abierto el mutex\n");
+		return -1;
+	}
+	if(ms < 0) {
+		printk("ERROR: plazo de lock_timeout no valido\n");
+		return -1;
+	}
+	// En long long para que un plazo largo no desborde y pase a
+	// significar sin limite o sin espera
+	ticks = ((long long)ms * TICK + 999) / 1000;
+	if (ticks > INT_MAX)
+		ticks = INT_MAX;
+	return lock_mutex(mutexid, (int)ticks);
+}
+
+/*
+ *	Funcion auxiliar que despierta al primer proceso que espera por un
+ *	mutex que acaba de quedar libre. En MODO_CESION el mutex pasa a ser
+ *	suyo; en MODO_COMPETENCIA vuelve a intentarlo y otro puede ganarle.
+ *	Return: el proceso al que se ha cedido el mutex, o NULL
+ */
+static BCP * entregar_mutex(unsigned int mutex_id) {
+	BCP *p_proc;
+
+	p_proc = desbloquear_proceso(&mutex[mutex_id]->bloqueados);
+	if(p_proc == NULL || mutex[mutex_id]->modo != MODO_CESION)
+		return NULL;
+	mutex[mutex_id]->bloqueado = 1;
+	mutex[mutex_id]->propietario = p_proc->id;
+	p_proc->mutex_cedido = 1;
+	return p_proc;
+}
+
+/*
+ *	Funcion auxiliar que desbloquea el mutex indicado. Usada por las
+ *	llamadas unlock y wait_cond. En cedido deja el proceso al que se ha
+ *	cedido el mutex, o NULL.
+ */
+static int unlock_mutex(unsigned int mutex_id, BCP **cedido) {
+	*cedido = NULL;
+	if(mutex_id >= (unsigned int)num_mut) {
+		printk("ERROR: descriptor de mutex no valido\n");
+		return -1;
+	}
 
 	//verificamos que existe el mutex
-	if(mutex[mutex_id].num_procs_en_mutex > 0) {
+	if((mutex[mutex_id] != NULL) && (mutex[mutex_id]->num_procs_en_mutex > 0)) {
 		//Comprobamos si esta bloqueado
-		if(mutex[mutex_id].bloqueado > 0) {
+		if(mutex[mutex_id]->bloqueado > 0) {
 			//Comprobamos el tipo
-			if(mutex[mutex_id].tipo == RECURSIVO) {
+			if(mutex[mutex_id]->tipo == RECURSIVO) {
 				//Comprobamos si es el dueno del bloqueo
-				if(mutex[mutex_id].propietario == p_proc_actual->id) {
+				if(mutex[mutex_id]->propietario == p_proc_actual->id) {
 					//Disminuimos el numero de bloqueos
-					mutex[mutex_id].bloqueado--;
-					if(mutex[mutex_id].bloqueado == 0) {
-						pr_bloqueado = lista_de_bloqueados.primero;
-						//Verificamos si hay algun proc en espera
-						if(pr_bloqueado != NULL) {
-							//Despertamos al proceso bloqueado
-							pr_bloqueado->estado = LISTO;
-							nivel_previo = fijar_nivel_int(NIVEL_3);
-							eliminar_primero(&lista_de_bloqueados);
-							insertar_ultimo(&lista_listos, pr_bloqueado);
-							fijar_nivel_int(nivel_previo);
-						}
+					mutex[mutex_id]->bloqueado--;
+					if(mutex[mutex_id]->bloqueado == 0) {
+						anotar_liberacion(mutex_id);
+						*cedido = entregar_mutex(mutex_id);
 					}
 				}
 				//En caso contrario, capturamos el error
@@ -760,24 +2112,17 @@ int sis_unlock() {
 				}
 			}
 			//En caso de NO_RECURSIVO
-			else if(mutex[mutex_id].tipo == NO_RECURSIVO) {
+			else if(mutex[mutex_id]->tipo == NO_RECURSIVO) {
 				//Verificamos si es el dueno
-				if(mutex[mutex_id].propietario == p_proc_actual->id) {
+				if(mutex[mutex_id]->propietario == p_proc_actual->id) {
 					//Desbloqueamos
-					mutex[mutex_id].bloqueado--;
-					if(mutex[mutex_id].bloqueado != 0) {
+					mutex[mutex_id]->bloqueado--;
+					if(mutex[mutex_id]->bloqueado != 0) {
 						printk("ERROR: intento de desbloqueo del mutex no recursivo ha fallado\n");
 						return -1;
 					}
-					pr_bloqueado = lista_de_bloqueados.primero;
-					//Verificamos si hay algun proceso en espera
-					if(pr_bloqueado != NULL) {
-						pr_bloqueado->estado = LISTO;
-						nivel_previo = fijar_nivel_int(NIVEL_3);
-						eliminar_primero(&lista_de_bloqueados);
-						insertar_ultimo(&lista_listos, pr_bloqueado);
-						fijar_nivel_int(nivel_previo);
-					}
+					anotar_liberacion(mutex_id);
+					*cedido = entregar_mutex(mutex_id);
 				}
 				else {
 					printk("ERROR: mutex tiene que ser boqueado por el mismo proceso\n");
@@ -785,7 +2130,7 @@ int sis_unlock() {
 			}
 		}
 		//En caso de no estar bloqueado
-		else if(mutex[mutex_id].bloqueado == 0) {
+		else if(mutex[mutex_id]->bloqueado == 0) {
 			printk("ERROR: un mutex no bloqueado no puede ser desbloqueado");
 		}
 		else {
@@ -800,122 +2145,1609 @@ int sis_unlock() {
 	return 0;
 }
 
+int sis_unlock() {
+	int mutex_id = objeto_descriptor(OBJ_MUTEX, (unsigned int)leer_argumento(1));
+	BCP *cedido;
+	BCP *p_proc_anterior;
+	int nivel;
 
-int sis_cerrar_mutex() {
-	BCP * pr_blocked_mutex;
-	BCP * pr_bloqueado;
-	int exists;
-	unsigned int mutex_id =(unsigned int)leer_registro(1);
-	// Comprobamos si existe el descriptor que se quiere cerrar
-	exists = existe_descriptor(mutex_id);
-	if(exists < 0) {
-		printk("ERROR: no existe el descriptor que se quiere cerrar");
+	if (mutex_id < 0) {
+		printk("ERROR: el proceso no tiene abierto el mutex\n");
 		return -1;
 	}
+	if(unlock_mutex(mutex_id, &cedido) < 0)
+		return -1;
+	if(cedido == NULL)
+		return 0;
+
+	// Con cesion, el nuevo propietario pasa a ejecutar inmediatamente y
+	// el proceso actual queda listo detras de el
+	nivel = fijar_nivel_int(NIVEL_LISTAS);
+	eliminar_elem(&lista_listos, cedido);
+	eliminar_primero(&lista_listos);
+	insertar_primero(&lista_listos, cedido);
+	insertar_ultimo(&lista_listos, p_proc_actual);
+	fijar_nivel_int(NIVEL_CAMBIO);
+	p_proc_anterior = p_proc_actual;
+	p_proc_actual = cedido;
+	printk("-> C.CONTEXTO POR CESION DE MUTEX: de %d a %d\n",
+			p_proc_anterior->id, p_proc_actual->id);
+	estadisticas.cambios[CAMBIO_MUTEX]++;
+	cambio_contexto(&(p_proc_anterior->contexto_regs),
+			&(p_proc_actual->contexto_regs));
+	fijar_nivel_int(nivel);
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema fijar_modo_mutex. Elige si al
+ *	liberar el mutex se cede al primero que espera o se le deja competir.
+ */
+int sis_fijar_modo_mutex() {
+	int mutex_id = objeto_descriptor(OBJ_MUTEX, (unsigned int)leer_argumento(1));
+	int modo = (int)leer_argumento(2);
 
-	p_proc_actual->descriptores[exists].libre = 0;
-	if(mutex[mutex_id].num_procs_en_mutex <= 0) {
-		printk("ERROR: el mutex cerrar no existe");
+	if(mutex_id < 0) {
+		printk("ERROR: el proceso no tiene abierto el mutex\n");
 		return -1;
 	}
-	mutex[mutex_id].num_procs_en_mutex--;
+	if(modo != MODO_COMPETENCIA && modo != MODO_CESION) {
+		printk("ERROR: modo de mutex no valido\n");
+		return -1;
+	}
+	mutex[mutex_id]->modo = modo;
+	return 0;
+}
+
+
+/*
+ *	Funcion auxiliar que cierra un mutex abierto por el proceso actual.
+ *	Si lo tenia bloqueado lo libera. Usada por cerrar_objeto.
+ */
+static void cerrar_mutex(unsigned int mutex_id) {
+	mutex[mutex_id]->num_procs_en_mutex--;
 	//Si ha llegado a cero, hay MUTEX disponible
-	if(mutex[mutex_id].propietario == p_proc_actual->id) {
-		mutex[mutex_id].bloqueado = 0;
-		pr_bloqueado = lista_de_bloqueados.primero;
-		if(pr_bloqueado != NULL) {
-			pr_bloqueado->estado = LISTO;
-			nivel_previo = fijar_nivel_int(NIVEL_3);
-			eliminar_primero(&lista_de_bloqueados);
-			insertar_ultimo(&lista_listos,pr_bloqueado);
-			fijar_nivel_int(nivel_previo);
-		}
+	if(mutex[mutex_id]->propietario == p_proc_actual->id) {
+		if(mutex[mutex_id]->bloqueado > 0)
+			anotar_liberacion(mutex_id);
+		mutex[mutex_id]->bloqueado = 0;
+		entregar_mutex(mutex_id);
 	}
-	if(mutex[mutex_id].num_procs_en_mutex == 0) {
-		pr_blocked_mutex = lista_de_mutex.primero;
-		//Verificamos si hay algun proceso esperando
-		if(pr_blocked_mutex != NULL) {
-			pr_blocked_mutex->estado = LISTO;
-			nivel_previo = fijar_nivel_int(NIVEL_3);
-			eliminar_primero(&lista_de_mutex);
-			insertar_ultimo(&lista_listos, pr_blocked_mutex);
-			fijar_nivel_int(nivel_previo);
-		}
+	if(mutex[mutex_id]->num_procs_en_mutex == 0) {
+		borrar_nombre(OBJ_MUTEX, mutex_id);
+		liberar_objeto(cache_mutex, mutex[mutex_id]);
+		mutex[mutex_id] = NULL;
+		despertar_creadores();
+	}
+}
+
+static void cerrar_objeto(int pos);
+
+int sis_cerrar_mutex() {
+	unsigned int desc = (unsigned int)leer_argumento(1);
+	int pos;
+
+	// Comprobamos si existe el descriptor que se quiere cerrar
+	if((pos = buscar_descriptor(OBJ_MUTEX, desc)) < 0) {
+		printk("ERROR: no existe el descriptor que se quiere cerrar\n");
+		return -1;
 	}
+	cerrar_objeto(pos);
 	return 0;
 }
 
 /*
- * Tratamiento de llamada al sistema crear_proceso. Llama a la
- * funcion auxiliar crear_tarea sis_terminar_proceso
+ *	Tratamiento de la llamada al sistema listar_mutex. Copia en buf el
+ *	nombre y los contadores de contencion de como mucho max mutex.
+ *	Return: numero de entradas copiadas
  */
-int sis_crear_proceso(){
-	char *prog;
-	int res;
+int sis_listar_mutex() {
+	struct info_mutex *buf = (struct info_mutex *)leer_argumento(1);
+	int max = (int)leer_argumento(2);
+	int i, n;
 
-	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
-	prog=(char *)leer_registro(1);
-	res=crear_tarea(prog);
-	return res;
+	if((buf == NULL) || (max < 0))
+		return -1;
+
+	for(i = 0, n = 0; (i < NUM_NOMBRES) && (n < max); i++)
+		if(registro_nombres[i].usado &&
+			(registro_nombres[i].tipo == OBJ_MUTEX)) {
+			strcpy(buf[n].nombre, registro_nombres[i].nombre);
+			buf[n].id = registro_nombres[i].id;
+			buf[n].contencion = mutex[buf[n].id]->contencion;
+			n++;
+		}
+	return n;
 }
 
 /*
- * Tratamiento de llamada al sistema escribir. Llama simplemente a la
- * funcion de apoyo escribir_ker
+ * Comienza la parte de SEMAFOROS y VARIABLES CONDICION
  */
-int sis_escribir()
-{
-	char *texto;
-	unsigned int longi;
 
-	texto=(char *)leer_registro(1);
-	longi=(unsigned int)leer_registro(2);
+/*
+* Funcion auxiliar que busca un semaforo libre en el sistema.
+* Return: Posicion si hay disponible
+* Return: -1 si error.
+*/
+static int sem_libre() {
+	int n;
+
+	for (n=0; n<NUM_SEM; n++)
+		if (semaforos[n] == NULL)
+			return n;
+	return -1;
+}
 
-	escribir_ker(texto, longi);
-	return 0;
+/*
+* Funcion auxiliar que busca una variable condicion libre en el sistema.
+* Return: Posicion si hay disponible
+* Return: -1 si error.
+*/
+static int cond_libre() {
+	int n;
+
+	for (n=0; n<NUM_COND; n++)
+		if (condiciones[n] == NULL)
+			return n;
+	return -1;
+}
+
+static void conceder_rw(int rw);
+
+/*
+* Funcion auxiliar que devuelve a su cache el semaforo, variable
+* condicion, cerrojo de lectores/escritores o cola indicado, que ya no
+* tiene abierto ningun proceso. Las regiones compartidas no se liberan.
+*/
+static void liberar_sincro(int tipo, int id) {
+	switch (tipo) {
+	case OBJ_SEM:
+		liberar_objeto(cache_sem, semaforos[id]);
+		semaforos[id] = NULL;
+		break;
+	case OBJ_COND:
+		liberar_objeto(cache_cond, condiciones[id]);
+		condiciones[id] = NULL;
+		break;
+	case OBJ_RW:
+		liberar_objeto(cache_rw, cerrojos_rw[id]);
+		cerrojos_rw[id] = NULL;
+		break;
+	case OBJ_COLA:
+		liberar_objeto(cache_cola, colas[id]);
+		colas[id] = NULL;
+		break;
+	}
+}
+
+/*
+* Funcion auxiliar que cierra el mutex, semaforo, variable condicion,
+* cerrojo de lectores/escritores, region compartida o cola de mensajes
+* asociado al descriptor indicado del proceso actual. Cuando ningun
+* proceso lo tiene abierto se borra su nombre y el objeto queda libre.
+*/
+static void cerrar_objeto(int pos) {
+	int tipo = p_proc_actual->descriptores[pos].tipo;
+	int id = p_proc_actual->descriptores[pos].descript;
+	int lecturas = p_proc_actual->descriptores[pos].lecturas;
+	int *num_procs;
+
+	liberar_descriptor(pos);
+	switch (tipo) {
+	case OBJ_MUTEX:
+		cerrar_mutex(id);
+		return;
+	case OBJ_SEM:
+		num_procs = &semaforos[id]->num_procs_en_sem;
+		break;
+	case OBJ_COND:
+		num_procs = &condiciones[id]->num_procs_en_cond;
+		break;
+	case OBJ_RW:
+		// Si lo tenia como escritor o como lector se libera al cerrarlo
+		if (cerrojos_rw[id]->escritor == p_proc_actual->id) {
+			cerrojos_rw[id]->escritor = -1;
+			conceder_rw(id);
+		}
+		else if (lecturas > 0) {
+			cerrojos_rw[id]->lectores -= lecturas;
+			conceder_rw(id);
+		}
+		num_procs = &cerrojos_rw[id]->num_procs_en_rw;
+		break;
+	case OBJ_MEM:
+		num_procs = &mem_comp[id].num_procs_en_mem;
+		break;
+	default:
+		num_procs = &colas[id]->num_procs_en_cola;
+		break;
+	}
+
+	(*num_procs)--;
+	if (*num_procs == 0) {
+		borrar_nombre(tipo, id);
+		liberar_sincro(tipo, id);
+	}
+}
+
+/*
+* Funcion auxiliar que realiza el cierre implicito de todos los objetos
+* abiertos por el proceso actual. Usada por liberar_proceso.
+*/
+static void cerrar_descriptores() {
+	int n;
+
+	while ((n = siguiente_descriptor(p_proc_actual, 0)) >= 0)
+		cerrar_objeto(n);
 }
 
 /*
- * Tratamiento de llamada al sistema terminar_proceso. Llama a la
- * funcion auxiliar liberar_proceso
+ *	Tratamiento de la llamada al sistema crear_sem. Crea un semaforo
+ *	contador con el nombre y valor inicial indicados.
  */
-int sis_terminar_proceso(){
+int sis_crear_sem() {
+	char *nombre = (char *)leer_argumento(1);
+	int valor = (int)leer_argumento(2);
+	int pos;
+	int sem;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	if (valor < 0) {
+		printk("ERROR: valor inicial de semaforo negativo\n");
+		return -1;
+	}
+	if (buscar_nombre(OBJ_SEM, nombre) >= 0) {
+		printk("ERROR: ya existe el semaforo\n");
+		return -1;
+	}
 
-	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
+	sem = sem_libre();
+	if (sem == -1) {
+		printk("ERROR: no quedan semaforos libres en el sistema\n");
+		return -1;
+	}
+	semaforos[sem] = reservar_objeto(cache_sem);
+	if (semaforos[sem] == NULL) {
+		printk("ERROR: no queda memoria para el semaforo\n");
+		return -1;
+	}
+	if (registrar_nombre(OBJ_SEM, nombre, sem) < 0) {
+		printk("ERROR: nombre de semaforo no valido\n");
+		liberar_sincro(OBJ_SEM, sem);
+		return -1;
+	}
 
-	liberar_proceso();
+	semaforos[sem]->valor = valor;
+	semaforos[sem]->num_procs_en_sem = 1;
+	semaforos[sem]->bloqueados.primero = NULL;
+	semaforos[sem]->bloqueados.ultimo = NULL;
 
-        return 0; /* no debera llegar aqui */
+	return ocupar_descriptor(pos, OBJ_SEM, sem);
 }
 
 /*
- *
- * Rutina de inicializacin invocada en arranque
- *
+ *	Tratamiento de la llamada al sistema abrir_sem.
  */
-int main(){
-	/* se llega con las interrupciones prohibidas */
+int sis_abrir_sem() {
+	char *nombre = (char *)leer_argumento(1);
+	int pos;
+	int sem;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	sem = buscar_nombre(OBJ_SEM, nombre);
+	if (sem < 0) {
+		printk("ERROR: no existe el semaforo en el sistema operativo\n");
+		return -1;
+	}
 
-	instal_man_int(EXC_ARITM, exc_arit); 
-	instal_man_int(EXC_MEM, exc_mem); 
-	instal_man_int(INT_RELOJ, int_reloj); 
-	instal_man_int(INT_TERMINAL, int_terminal); 
-	instal_man_int(LLAM_SIS, tratar_llamsis); 
-	instal_man_int(INT_SW, int_sw); 
+	semaforos[sem]->num_procs_en_sem++;
+	return ocupar_descriptor(pos, OBJ_SEM, sem);
+}
 
-	iniciar_cont_int();		/* inicia cont. interr. */
-	iniciar_cont_reloj(TICK);	/* fija frecuencia del reloj */
-	iniciar_cont_teclado();		/* inici cont. teclado */
+/*
+ *	Tratamiento de la llamada al sistema wait_sem. Si el contador es
+ *	cero el proceso se bloquea en la cola del semaforo.
+ */
+int sis_wait_sem() {
+	int sem = objeto_descriptor(OBJ_SEM, (unsigned int)leer_argumento(1));
 
-	iniciar_tabla_proc();		/* inicia BCPs de tabla de procesos */
+	if (sem < 0) {
+		printk("ERROR: el proceso no tiene abierto el semaforo\n");
+		return -1;
+	}
 
-	/* crea proceso inicial */
-	if (crear_tarea((void *)"init")<0)
-		panico("no encontrado el proceso inicial");
-	
-	/* activa proceso inicial */
-	p_proc_actual=planificador();
-	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+	if (semaforos[sem]->valor > 0) {
+		semaforos[sem]->valor--;
+		return 0;
+	}
+	// El signal_sem que nos despierte nos cede directamente la unidad,
+	// por lo que no hay que volver a comprobar el contador
+	bloquear_proceso(&semaforos[sem]->bloqueados);
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema signal_sem. Si hay procesos
+ *	esperando se despierta solo al primero; si no, se incrementa el
+ *	contador.
+ */
+int sis_signal_sem() {
+	int sem = objeto_descriptor(OBJ_SEM, (unsigned int)leer_argumento(1));
+
+	if (sem < 0) {
+		printk("ERROR: el proceso no tiene abierto el semaforo\n");
+		return -1;
+	}
+
+	if (desbloquear_proceso(&semaforos[sem]->bloqueados) == NULL)
+		semaforos[sem]->valor++;
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema cerrar_sem.
+ */
+int sis_cerrar_sem() {
+	unsigned int desc = (unsigned int)leer_argumento(1);
+	int pos;
+
+	if ((pos = buscar_descriptor(OBJ_SEM, desc)) < 0) {
+		printk("ERROR: no existe el descriptor que se quiere cerrar\n");
+		return -1;
+	}
+	cerrar_objeto(pos);
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema crear_cond.
+ */
+int sis_crear_cond() {
+	char *nombre = (char *)leer_argumento(1);
+	int pos;
+	int cond;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	if (buscar_nombre(OBJ_COND, nombre) >= 0) {
+		printk("ERROR: ya existe la variable condicion\n");
+		return -1;
+	}
+
+	cond = cond_libre();
+	if (cond == -1) {
+		printk("ERROR: no quedan variables condicion libres en el sistema\n");
+		return -1;
+	}
+	condiciones[cond] = reservar_objeto(cache_cond);
+	if (condiciones[cond] == NULL) {
+		printk("ERROR: no queda memoria para la variable condicion\n");
+		return -1;
+	}
+	if (registrar_nombre(OBJ_COND, nombre, cond) < 0) {
+		printk("ERROR: nombre de variable condicion no valido\n");
+		liberar_sincro(OBJ_COND, cond);
+		return -1;
+	}
+
+	condiciones[cond]->num_procs_en_cond = 1;
+	condiciones[cond]->bloqueados.primero = NULL;
+	condiciones[cond]->bloqueados.ultimo = NULL;
+
+	return ocupar_descriptor(pos, OBJ_COND, cond);
+}
+
+/*
+ *	Tratamiento de la llamada al sistema abrir_cond.
+ */
+int sis_abrir_cond() {
+	char *nombre = (char *)leer_argumento(1);
+	int pos;
+	int cond;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	cond = buscar_nombre(OBJ_COND, nombre);
+	if (cond < 0) {
+		printk("ERROR: no existe la variable condicion en el sistema operativo\n");
+		return -1;
+	}
+
+	condiciones[cond]->num_procs_en_cond++;
+	return ocupar_descriptor(pos, OBJ_COND, cond);
+}
+
+/*
+ *	Tratamiento de la llamada al sistema wait_cond. Libera el mutex
+ *	indicado, que debe tener bloqueado el proceso, y se bloquea en la
+ *	condicion. Al despertar vuelve a adquirir el mutex.
+ */
+int sis_wait_cond() {
+	int cond = objeto_descriptor(OBJ_COND, (unsigned int)leer_argumento(1));
+	int mutexid = objeto_descriptor(OBJ_MUTEX, (unsigned int)leer_argumento(2));
+	int profundidad;
+	BCP *cedido;
+
+	if (cond < 0) {
+		printk("ERROR: el proceso no tiene abierta la variable condicion\n");
+		return -1;
+	}
+	if ((mutexid < 0) || (mutex[mutexid]->bloqueado <= 0)
+		|| (mutex[mutexid]->propietario != p_proc_actual->id)) {
+		printk("ERROR: wait_cond requiere tener bloqueado el mutex\n");
+		return -1;
+	}
+
+	// El mutex se libera por completo aunque sea recursivo. Como entre la
+	// liberacion y el bloqueo no hay cambio de contexto, ningun signal_cond
+	// puede perderse. Por eso aqui no se cede el procesador aunque el
+	// mutex se haya cedido a otro proceso.
+	profundidad = mutex[mutexid]->bloqueado;
+	mutex[mutexid]->bloqueado = 1;
+	unlock_mutex(mutexid, &cedido);
+	bloquear_proceso(&condiciones[cond]->bloqueados);
+
+	// Recuperamos el mutex con el mismo numero de bloqueos que tenia
+	if (lock_mutex(mutexid, -1) < 0)
+		return -1;
+	mutex[mutexid]->bloqueado = profundidad;
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema signal_cond. Despierta al
+ *	primer proceso esperando en la condicion, si lo hay.
+ */
+int sis_signal_cond() {
+	int cond = objeto_descriptor(OBJ_COND, (unsigned int)leer_argumento(1));
+
+	if (cond < 0) {
+		printk("ERROR: el proceso no tiene abierta la variable condicion\n");
+		return -1;
+	}
+	desbloquear_proceso(&condiciones[cond]->bloqueados);
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema broadcast_cond. Despierta a
+ *	todos los procesos esperando en la condicion.
+ */
+int sis_broadcast_cond() {
+	int cond = objeto_descriptor(OBJ_COND, (unsigned int)leer_argumento(1));
+
+	if (cond < 0) {
+		printk("ERROR: el proceso no tiene abierta la variable condicion\n");
+		return -1;
+	}
+	while (desbloquear_proceso(&condiciones[cond]->bloqueados) != NULL);
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema cerrar_cond.
+ */
+int sis_cerrar_cond() {
+	unsigned int desc = (unsigned int)leer_argumento(1);
+	int pos;
+
+	if ((pos = buscar_descriptor(OBJ_COND, desc)) < 0) {
+		printk("ERROR: no existe el descriptor que se quiere cerrar\n");
+		return -1;
+	}
+	cerrar_objeto(pos);
+	return 0;
+}
+
+/*
+ * Comienza la parte de cerrojos de LECTORES/ESCRITORES
+ */
+
+/*
+* Funcion auxiliar que busca un cerrojo de lectores/escritores libre.
+* Return: Posicion si hay disponible
+* Return: -1 si error.
+*/
+static int rw_libre() {
+	int n;
+
+	for (n=0; n<NUM_RW; n++)
+		if (cerrojos_rw[n] == NULL)
+			return n;
+	return -1;
+}
+
+/*
+* Funcion auxiliar que concede el cerrojo a los procesos en espera que
+* puedan obtenerlo. La propiedad se cede antes de despertarlos, por lo
+* que no tienen que volver a comprobar el estado del cerrojo.
+* En RW_FIFO la cola se atiende en orden de llegada: un escritor en
+* cabeza detiene a los lectores que llegaron despues que el. En
+* RW_PREF_ESCRITORES cualquier escritor en espera pasa por delante.
+*/
+static void conceder_rw(int rw) {
+	tipo_rwlock *c = cerrojos_rw[rw];
+	BCP * p_proc;
+
+	if (c->escritor != -1)
+		return;
+
+	if ((c->tipo == RW_PREF_ESCRITORES) && (c->escritores_esperando > 0)) {
+		if (c->lectores > 0)
+			return;
+		for (p_proc = c->bloqueados.primero;
+			p_proc->modo_rw != RW_ESCRITURA; p_proc = p_proc->siguiente);
+		c->escritor = p_proc->id;
+		c->escritores_esperando--;
+		desbloquear_elem(&c->bloqueados, p_proc);
+		return;
+	}
+
+	while ((p_proc = c->bloqueados.primero) != NULL) {
+		if (p_proc->modo_rw == RW_ESCRITURA) {
+			if (c->lectores == 0) {
+				c->escritor = p_proc->id;
+				c->escritores_esperando--;
+				desbloquear_proceso(&c->bloqueados);
+			}
+			return;
+		}
+		c->lectores++;
+		desbloquear_proceso(&c->bloqueados);
+	}
+}
+
+/*
+ *	Tratamiento de la llamada al sistema crear_rw. El tipo indica la
+ *	politica: RW_FIFO o RW_PREF_ESCRITORES.
+ */
+int sis_crear_rw() {
+	char *nombre = (char *)leer_argumento(1);
+	int tipo = (int)leer_argumento(2);
+	int pos;
+	int rw;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	if ((tipo != RW_FIFO) && (tipo != RW_PREF_ESCRITORES)) {
+		printk("ERROR: tipo de cerrojo de lectores/escritores no valido\n");
+		return -1;
+	}
+	if (buscar_nombre(OBJ_RW, nombre) >= 0) {
+		printk("ERROR: ya existe el cerrojo de lectores/escritores\n");
+		return -1;
+	}
+
+	rw = rw_libre();
+	if (rw == -1) {
+		printk("ERROR: no quedan cerrojos de lectores/escritores libres\n");
+		return -1;
+	}
+	cerrojos_rw[rw] = reservar_objeto(cache_rw);
+	if (cerrojos_rw[rw] == NULL) {
+		printk("ERROR: no queda memoria para el cerrojo de lectores/escritores\n");
+		return -1;
+	}
+	if (registrar_nombre(OBJ_RW, nombre, rw) < 0) {
+		printk("ERROR: nombre de cerrojo no valido\n");
+		liberar_sincro(OBJ_RW, rw);
+		return -1;
+	}
+
+	cerrojos_rw[rw]->num_procs_en_rw = 1;
+	cerrojos_rw[rw]->tipo = tipo;
+	cerrojos_rw[rw]->lectores = 0;
+	cerrojos_rw[rw]->escritor = -1;
+	cerrojos_rw[rw]->escritores_esperando = 0;
+	cerrojos_rw[rw]->bloqueados.primero = NULL;
+	cerrojos_rw[rw]->bloqueados.ultimo = NULL;
+
+	return ocupar_descriptor(pos, OBJ_RW, rw);
+}
+
+/*
+ *	Tratamiento de la llamada al sistema abrir_rw.
+ */
+int sis_abrir_rw() {
+	char *nombre = (char *)leer_argumento(1);
+	int pos;
+	int rw;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	rw = buscar_nombre(OBJ_RW, nombre);
+	if (rw < 0) {
+		printk("ERROR: no existe el cerrojo en el sistema operativo\n");
+		return -1;
+	}
+
+	cerrojos_rw[rw]->num_procs_en_rw++;
+	return ocupar_descriptor(pos, OBJ_RW, rw);
+}
+
+/*
+ *	Tratamiento de la llamada al sistema lock_lectura. Varios lectores
+ *	pueden tener el cerrojo a la vez mientras no haya escritor.
+ */
+int sis_lock_lectura() {
+	int pos = buscar_descriptor(OBJ_RW, (unsigned int)leer_argumento(1));
+	tipo_rwlock *c;
+	int espera;
+
+	if (pos < 0) {
+		printk("ERROR: el proceso no tiene abierto el cerrojo\n");
+		return -1;
+	}
+	c = cerrojos_rw[p_proc_actual->descriptores[pos].descript];
+	if (c->escritor == p_proc_actual->id) {
+		printk("ERROR: se esta produciendo un caso de interbloqueo trivial\n");
+		return -1;
+	}
+
+	// En RW_FIFO no se adelanta a nadie que este esperando; con
+	// preferencia de escritores solo se espera si hay escritores
+	if (c->tipo == RW_FIFO)
+		espera = (c->bloqueados.primero != NULL);
+	else
+		espera = (c->escritores_esperando > 0);
+
+	if ((c->escritor == -1) && !espera)
+		c->lectores++;
+	else {
+		p_proc_actual->modo_rw = RW_LECTURA;
+		bloquear_proceso(&c->bloqueados);
+		// Al despertar conceder_rw ya nos ha contado como lector
+	}
+	// La lectura se apunta en el descriptor para liberarla al cerrarlo
+	p_proc_actual->descriptores[pos].lecturas++;
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema lock_escritura. El escritor
+ *	obtiene el cerrojo en exclusiva.
+ */
+int sis_lock_escritura() {
+	int rw = objeto_descriptor(OBJ_RW, (unsigned int)leer_argumento(1));
+	tipo_rwlock *c;
+
+	if (rw < 0) {
+		printk("ERROR: el proceso no tiene abierto el cerrojo\n");
+		return -1;
+	}
+	c = cerrojos_rw[rw];
+	if (c->escritor == p_proc_actual->id) {
+		printk("ERROR: se esta produciendo un caso de interbloqueo trivial\n");
+		return -1;
+	}
+
+	if ((c->escritor == -1) && (c->lectores == 0)
+		&& (c->bloqueados.primero == NULL)) {
+		c->escritor = p_proc_actual->id;
+		return 0;
+	}
+	p_proc_actual->modo_rw = RW_ESCRITURA;
+	c->escritores_esperando++;
+	bloquear_proceso(&c->bloqueados);
+	// Al despertar conceder_rw ya nos ha hecho propietarios
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema unlock_rw. Libera el cerrojo
+ *	tanto si se tenia como lector como si se tenia como escritor.
+ */
+int sis_unlock_rw() {
+	int pos = buscar_descriptor(OBJ_RW, (unsigned int)leer_argumento(1));
+	tipo_descriptor *d;
+	tipo_rwlock *c;
+	int rw;
+
+	if (pos < 0) {
+		printk("ERROR: el proceso no tiene abierto el cerrojo\n");
+		return -1;
+	}
+	d = &p_proc_actual->descriptores[pos];
+	rw = d->descript;
+	c = cerrojos_rw[rw];
+
+	// Solo se libera una lectura que haya obtenido este descriptor
+	if (c->escritor == p_proc_actual->id)
+		c->escritor = -1;
+	else if (d->lecturas > 0) {
+		d->lecturas--;
+		c->lectores--;
+	}
+	else {
+		printk("ERROR: un cerrojo no concedido no puede ser liberado\n");
+		return -1;
+	}
+	conceder_rw(rw);
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema cerrar_rw.
+ */
+int sis_cerrar_rw() {
+	unsigned int desc = (unsigned int)leer_argumento(1);
+	int pos;
+
+	if ((pos = buscar_descriptor(OBJ_RW, desc)) < 0) {
+		printk("ERROR: no existe el descriptor que se quiere cerrar\n");
+		return -1;
+	}
+	cerrar_objeto(pos);
+	return 0;
+}
+
+/*
+ * Comienza la parte de MEMORIA COMPARTIDA
+ */
+
+/*
+* Funcion auxiliar que busca una region compartida libre.
+* Return: Posicion si hay disponible
+* Return: -1 si error.
+*/
+static int mem_comp_libre() {
+	int n;
+
+	for (n=0; n<NUM_MEM_COMP; n++)
+		if (mem_comp[n].num_procs_en_mem <= 0)
+			return n;
+	return -1;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema crear_memoria_compartida. Reserva
+ *	una region del tamano indicado y devuelve su direccion en el tercer
+ *	parametro. Los datos no se copian: todos los procesos que la abran
+ *	acceden a la misma zona.
+ */
+int sis_crear_mem_comp() {
+	char *nombre = (char *)leer_argumento(1);
+	int tam = (int)leer_argumento(2);
+	void **dir = (void **)leer_argumento(3);
+	int pos;
+	int mem;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	if ((tam <= 0) || (tam > TAM_MAX_MEM_COMP) || (dir == NULL)) {
+		printk("ERROR: parametros de memoria compartida no validos\n");
+		return -1;
+	}
+	if (buscar_nombre(OBJ_MEM, nombre) >= 0) {
+		printk("ERROR: ya existe la region compartida\n");
+		return -1;
+	}
+
+	mem = mem_comp_libre();
+	if (mem == -1) {
+		printk("ERROR: no quedan regiones compartidas libres\n");
+		return -1;
+	}
+	if (registrar_nombre(OBJ_MEM, nombre, mem) < 0) {
+		printk("ERROR: nombre de region compartida no valido\n");
+		return -1;
+	}
+
+	mem_comp[mem].num_procs_en_mem = 1;
+	mem_comp[mem].tam = tam;
+	memset(zona_mem_comp[mem], 0, tam);
+
+	ocupar_descriptor(pos, OBJ_MEM, mem);
+	*dir = zona_mem_comp[mem];
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema abrir_memoria_compartida.
+ *	Devuelve la direccion de la region en el segundo parametro.
+ */
+int sis_abrir_mem_comp() {
+	char *nombre = (char *)leer_argumento(1);
+	void **dir = (void **)leer_argumento(2);
+	int pos;
+	int mem;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	if (dir == NULL) {
+		printk("ERROR: parametros de memoria compartida no validos\n");
+		return -1;
+	}
+	mem = buscar_nombre(OBJ_MEM, nombre);
+	if (mem < 0) {
+		printk("ERROR: no existe la region compartida en el sistema operativo\n");
+		return -1;
+	}
+
+	mem_comp[mem].num_procs_en_mem++;
+	ocupar_descriptor(pos, OBJ_MEM, mem);
+	*dir = zona_mem_comp[mem];
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema cerrar_memoria_compartida. Recibe
+ *	la direccion devuelta al crear o abrir la region.
+ */
+int sis_cerrar_mem_comp() {
+	char *dir = (char *)leer_argumento(1);
+	int mem;
+	int pos;
+
+	for (mem=0; (mem<NUM_MEM_COMP) && (zona_mem_comp[mem] != dir); mem++);
+
+	if ((mem == NUM_MEM_COMP) || ((pos = descriptor_de_objeto(p_proc_actual, OBJ_MEM, mem)) < 0)) {
+		printk("ERROR: no existe el descriptor que se quiere cerrar\n");
+		return -1;
+	}
+	cerrar_objeto(pos);
+	return 0;
+}
+
+/*
+ * Comienza la parte de COLAS DE MENSAJES
+ */
+
+/*
+* Funcion auxiliar que busca una cola de mensajes libre.
+* Return: Posicion si hay disponible
+* Return: -1 si error.
+*/
+static int cola_libre() {
+	int n;
+
+	for (n=0; n<NUM_COLAS; n++)
+		if (colas[n] == NULL)
+			return n;
+	return -1;
+}
+
+/*
+* Funcion auxiliar que copia un mensaje al final de la cola. Debe
+* haber hueco.
+*/
+static void encolar_mensaje(tipo_cola *c, char *mensaje, int longitud) {
+	int pos = (c->primero + c->num_mensajes) % c->capacidad;
+
+	memcpy(c->mensajes[pos], mensaje, longitud);
+	c->longitudes[pos] = longitud;
+	c->num_mensajes++;
+}
+
+/*
+* Funcion auxiliar que extrae el mensaje mas antiguo de la cola. Debe
+* haber alguno.
+* Return: numero de bytes copiados en buf
+*/
+static int desencolar_mensaje(tipo_cola *c, char *buf, int longitud) {
+	int pos = c->primero;
+
+	if (longitud > c->longitudes[pos])
+		longitud = c->longitudes[pos];
+	memcpy(buf, c->mensajes[pos], longitud);
+	c->primero = (c->primero + 1) % c->capacidad;
+	c->num_mensajes--;
+	return longitud;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema crear_cola. Crea una cola con
+ *	capacidad para el numero de mensajes indicado, cada uno de ellos de
+ *	como mucho tam_mensaje bytes.
+ */
+int sis_crear_cola() {
+	char *nombre = (char *)leer_argumento(1);
+	int capacidad = (int)leer_argumento(2);
+	int tam_mensaje = (int)leer_argumento(3);
+	int pos;
+	int cola;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	if ((capacidad <= 0) || (capacidad > MAX_MENSAJES)
+		|| (tam_mensaje <= 0) || (tam_mensaje > TAM_MAX_MENSAJE)) {
+		printk("ERROR: dimensiones de cola de mensajes no validas\n");
+		return -1;
+	}
+	if (buscar_nombre(OBJ_COLA, nombre) >= 0) {
+		printk("ERROR: ya existe la cola de mensajes\n");
+		return -1;
+	}
+
+	cola = cola_libre();
+	if (cola == -1) {
+		printk("ERROR: no quedan colas de mensajes libres\n");
+		return -1;
+	}
+	colas[cola] = reservar_objeto(cache_cola);
+	if (colas[cola] == NULL) {
+		printk("ERROR: no queda memoria para la cola de mensajes\n");
+		return -1;
+	}
+	if (registrar_nombre(OBJ_COLA, nombre, cola) < 0) {
+		printk("ERROR: nombre de cola de mensajes no valido\n");
+		liberar_sincro(OBJ_COLA, cola);
+		return -1;
+	}
+
+	colas[cola]->num_procs_en_cola = 1;
+	colas[cola]->capacidad = capacidad;
+	colas[cola]->tam_mensaje = tam_mensaje;
+	colas[cola]->primero = 0;
+	colas[cola]->num_mensajes = 0;
+	colas[cola]->esperando_hueco.primero = NULL;
+	colas[cola]->esperando_hueco.ultimo = NULL;
+	colas[cola]->esperando_mensaje.primero = NULL;
+	colas[cola]->esperando_mensaje.ultimo = NULL;
+
+	return ocupar_descriptor(pos, OBJ_COLA, cola);
+}
+
+/*
+ *	Tratamiento de la llamada al sistema abrir_cola.
+ */
+int sis_abrir_cola() {
+	char *nombre = (char *)leer_argumento(1);
+	int pos;
+	int cola;
+
+	pos = existe_descriptor();
+	if (pos == -1) {
+		printk("ERROR: no hay descriptores libres para el proceso %d\n",
+			p_proc_actual->id);
+		return -1;
+	}
+	cola = buscar_nombre(OBJ_COLA, nombre);
+	if (cola < 0) {
+		printk("ERROR: no existe la cola de mensajes en el sistema operativo\n");
+		return -1;
+	}
+
+	colas[cola]->num_procs_en_cola++;
+	return ocupar_descriptor(pos, OBJ_COLA, cola);
+}
+
+/*
+ *	Tratamiento de la llamada al sistema enviar. Si hay un receptor
+ *	esperando se le entrega el mensaje directamente. Si la cola esta
+ *	llena el emisor se bloquea, salvo que se pida no bloquear, en cuyo
+ *	caso se devuelve error.
+ */
+int sis_enviar() {
+	int cola = objeto_descriptor(OBJ_COLA, (unsigned int)leer_argumento(1));
+	char *mensaje = (char *)leer_argumento(2);
+	int longitud = (int)leer_argumento(3);
+	int no_bloquear = (int)leer_argumento(4);
+	tipo_cola *c;
+	BCP * receptor;
+
+	if (cola < 0) {
+		printk("ERROR: el proceso no tiene abierta la cola\n");
+		return -1;
+	}
+	c = colas[cola];
+	if ((longitud < 0) || (longitud > c->tam_mensaje)) {
+		printk("ERROR: longitud de mensaje no valida\n");
+		return -1;
+	}
+
+	// Con un receptor esperando la cola esta vacia: se copia el mensaje
+	// en su buffer y se le despierta una sola vez
+	receptor = c->esperando_mensaje.primero;
+	if (receptor != NULL) {
+		if (longitud > receptor->long_ipc)
+			longitud = receptor->long_ipc;
+		memcpy(receptor->buf_ipc, mensaje, longitud);
+		receptor->long_ipc = longitud;
+		desbloquear_proceso(&c->esperando_mensaje);
+		return 0;
+	}
+
+	if (c->num_mensajes < c->capacidad) {
+		encolar_mensaje(c, mensaje, longitud);
+		return 0;
+	}
+
+	if (no_bloquear)
+		return -1;
+
+	// El receptor que libere un hueco encolara nuestro mensaje antes
+	// de despertarnos
+	p_proc_actual->buf_ipc = mensaje;
+	p_proc_actual->long_ipc = longitud;
+	bloquear_proceso(&c->esperando_hueco);
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema recibir. Devuelve la longitud
+ *	del mensaje recibido. Si la cola esta vacia el receptor se bloquea,
+ *	salvo que se pida no bloquear, en cuyo caso se devuelve error.
+ */
+int sis_recibir() {
+	int cola = objeto_descriptor(OBJ_COLA, (unsigned int)leer_argumento(1));
+	char *buf = (char *)leer_argumento(2);
+	int longitud = (int)leer_argumento(3);
+	int no_bloquear = (int)leer_argumento(4);
+	tipo_cola *c;
+	BCP * emisor;
+	int recibidos;
+
+	if (cola < 0) {
+		printk("ERROR: el proceso no tiene abierta la cola\n");
+		return -1;
+	}
+	if (longitud < 0) {
+		printk("ERROR: longitud de buffer no valida\n");
+		return -1;
+	}
+	c = colas[cola];
+
+	if (c->num_mensajes == 0) {
+		if (no_bloquear)
+			return -1;
+		// El emisor que nos despierte habra copiado ya el mensaje
+		p_proc_actual->buf_ipc = buf;
+		p_proc_actual->long_ipc = longitud;
+		bloquear_proceso(&c->esperando_mensaje);
+		return p_proc_actual->long_ipc;
+	}
+
+	recibidos = desencolar_mensaje(c, buf, longitud);
+
+	// Se ha liberado un hueco: se encola el mensaje del primer emisor
+	// bloqueado y se le despierta
+	emisor = c->esperando_hueco.primero;
+	if (emisor != NULL) {
+		encolar_mensaje(c, emisor->buf_ipc, emisor->long_ipc);
+		desbloquear_proceso(&c->esperando_hueco);
+	}
+	return recibidos;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema cerrar_cola.
+ */
+int sis_cerrar_cola() {
+	unsigned int desc = (unsigned int)leer_argumento(1);
+	int pos;
+
+	if ((pos = buscar_descriptor(OBJ_COLA, desc)) < 0) {
+		printk("ERROR: no existe el descriptor que se quiere cerrar\n");
+		return -1;
+	}
+	cerrar_objeto(pos);
+	return 0;
+}
+
+/*
+*
+* Funciones relacionadas con los HILOS
+*
+*/
+
+/*
+ *	Tratamiento de la llamada al sistema crear_hilo. Crea un nuevo BCP
+ *	que comparte la imagen del proceso actual pero con su propia pila.
+ *	El hilo arranca en la rutina de biblioteca indicada, que obtiene la
+ *	funcion y el argumento mediante datos_hilo.
+ *	Return: identificador del hilo
+ *	Return: -1 si error
+ */
+int sis_crear_hilo() {
+	void *pc_inicial = (void *)leer_argumento(1);
+	int proc;
+	BCP *p_proc;
+
+	printk("-> PROC %d: CREAR HILO\n", p_proc_actual->id);
+	proc=buscar_BCP_libre();
+	if (proc==-1) {
+		printk("ERROR: no hay BCPs libres para crear el hilo\n");
+		return -1;
+	}
+	p_proc=&(tabla_procs[proc]);
+	p_proc->es_hilo=1;
+	p_proc->padre=-1;
+	p_proc->funcion_hilo=(void *)leer_argumento(2);
+	p_proc->arg_hilo=(void *)leer_argumento(3);
+	iniciar_tarea(p_proc, proc, p_proc_actual->imagen, pc_inicial);
+	estadisticas.procesos_creados++;
+	return proc;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema datos_hilo. Devuelve al hilo
+ *	actual la funcion y el argumento con los que se creo, y a un proceso
+ *	que arranca en inicio_proceso su main.
+ */
+int sis_datos_hilo() {
+	void **funcion = (void **)leer_argumento(1);
+	void **arg = (void **)leer_argumento(2);
+
+	if (p_proc_actual->funcion_hilo==NULL)
+		return -1;
+	*funcion=p_proc_actual->funcion_hilo;
+	*arg=p_proc_actual->arg_hilo;
+	return 0;
+}
+
+/*
+ *	Tratamiento de la llamada al sistema terminar_hilo. Guarda el valor
+ *	de salida y termina el hilo actual.
+ */
+int sis_terminar_hilo() {
+	printk("-> FIN HILO %d\n", p_proc_actual->id);
+	p_proc_actual->valor_salida=(int)leer_argumento(1);
+	liberar_proceso();
+
+	return 0; /* no deberia llegar aqui */
+}
+
+/*
+ *	Tratamiento de la llamada al sistema esperar_hilo. Espera a que
+ *	termine un hilo de la misma imagen y recoge su valor de salida.
+ *	Solo puede haber un hilo esperando a otro.
+ */
+int sis_esperar_hilo() {
+	unsigned int id = (unsigned int)leer_argumento(1);
+	int *valor = (int *)leer_argumento(2);
+	BCP *p_hilo;
+
+	if (id >= MAX_PROC) {
+		printk("ERROR: no existe el hilo %d\n", id);
+		return -1;
+	}
+	p_hilo=&(tabla_procs[id]);
+	if ((p_hilo->estado==NO_USADA) || !p_hilo->es_hilo ||
+		(p_hilo==p_proc_actual) ||
+		(p_hilo->imagen!=p_proc_actual->imagen)) {
+		printk("ERROR: %d no es un hilo de este proceso\n", id);
+		return -1;
+	}
+	if (p_hilo->esperando_fin.primero!=NULL) {
+		printk("ERROR: ya hay un hilo esperando a %d\n", id);
+		return -1;
+	}
+
+	if (p_hilo->estado!=ZOMBI)
+		bloquear_proceso(&(p_hilo->esperando_fin));
+
+	if (valor!=NULL)
+		*valor=p_hilo->valor_salida;
+	p_hilo->estado=NO_USADA;
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_proceso. Llama a la
+ * funcion auxiliar crear_tarea sis_terminar_proceso
+ * Return: identificador del proceso creado o -1 si error
+ */
+int sis_crear_proceso(){
+	char *prog;
+	int res;
+
+	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
+	prog=(char *)leer_argumento(1);
+	res=crear_tarea(prog);
+	return res;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_procesos. Crea de una vez n
+ * procesos del mismo programa y devuelve sus identificadores en pids.
+ * Si no se pueden crear todos no se crea ninguno.
+ */
+int sis_crear_procesos(){
+	char *prog;
+	int n;
+	int *pids;
+
+	prog=(char *)leer_argumento(1);
+	n=(int)leer_argumento(2);
+	pids=(int *)leer_argumento(3);
+	printk("-> PROC %d: CREAR %d PROCESOS\n", p_proc_actual->id, n);
+
+	if (pids==NULL)
+		return -1;
+	return crear_tareas(prog, n, pids);
+}
+
+/*
+ * Tratamiento de llamada al sistema escribir. Llama simplemente a la
+ * funcion de apoyo escribir_ker
+ */
+int sis_escribir()
+{
+	char *texto;
+	unsigned int longi;
+
+	texto=(char *)leer_argumento(1);
+	longi=(unsigned int)leer_argumento(2);
+
+	escribir_ker(texto, longi);
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema terminar_proceso. Guarda el estado
+ * de salida y llama a la funcion auxiliar liberar_proceso
+ */
+int sis_terminar_proceso(){
+
+	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
+
+	p_proc_actual->valor_salida=(int)leer_argumento(1);
+	liberar_proceso();
+
+        return 0; /* no debera llegar aqui */
+}
+
+/*
+ * Tratamiento de llamada al sistema perfil. Activa el perfilado
+ * estadistico del proceso actual: en cada tick en modo usuario se
+ * incrementa la celda desplazamiento/escala del histograma. Con un
+ * histograma nulo se desactiva.
+ */
+int sis_perfil(){
+	unsigned int *buf = (unsigned int *)leer_argumento(1);
+	int tam = (int)leer_argumento(2);
+	int escala = (int)leer_argumento(3);
+
+	if (buf==NULL) {
+		p_proc_actual->perfil=NULL;
+		return 0;
+	}
+	if ((tam<=0) || (escala<=0)) {
+		printk("ERROR: histograma de perfilado no valido\n");
+		return -1;
+	}
+	p_proc_actual->tam_perfil=tam;
+	p_proc_actual->escala_perfil=escala;
+	p_proc_actual->perfil=buf;
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema obtener_latencias. Copia el
+ * histograma de secciones enmascaradas y, de mayor a menor maximo, los
+ * NUM_PUESTOS_LATENCIA sitios con la seccion mas larga.
+ */
+int sis_obtener_latencias(){
+	struct latencias *l = (struct latencias *)leer_argumento(1);
+	int elegido[MAX_SITIOS_LATENCIA];
+	tipo_sitio *s;
+	int i, j, mejor;
+	int nivel;
+
+	if (l==NULL)
+		return -1;
+
+	nivel = fijar_nivel_int(NIVEL_RELOJ);
+	*l=latencias;
+	for (i=0; i<latencias.sitios; i++)
+		elegido[i]=0;
+	for (j=0; (j<NUM_PUESTOS_LATENCIA) && (j<latencias.sitios); j++) {
+		mejor=-1;
+		for (i=0; i<latencias.sitios; i++)
+			if (!elegido[i] && ((mejor<0) ||
+				(sitios_latencia[i].max_ns>sitios_latencia[mejor].max_ns)))
+				mejor=i;
+		elegido[mejor]=1;
+		s=&sitios_latencia[mejor];
+		strncpy(l->puestos[j].funcion, s->funcion, MAX_NOM_SITIO);
+		l->puestos[j].funcion[MAX_NOM_SITIO]='\0';
+		l->puestos[j].linea=s->linea;
+		l->puestos[j].veces=s->veces;
+		l->puestos[j].max_ns=s->max_ns;
+		l->puestos[j].total_ns=s->total_ns;
+	}
+	l->num_puestos=j;
+	fijar_nivel_int(nivel);
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema obtener_estadisticas. Completa los
+ * datos que no se mantienen como contadores y copia como mucho tam
+ * bytes de la estructura, de forma que un programa compilado con una
+ * version anterior sigue funcionando.
+ * Return: version de la estructura del nucleo
+ */
+int sis_obtener_estadisticas(){
+	struct estadisticas *e = (struct estadisticas *)leer_argumento(1);
+	int tam = (int)leer_argumento(2);
+	int i;
+	int nivel;
+
+	if ((e==NULL) || (tam<(int)sizeof(int)))
+		return -1;
+
+	nivel = fijar_nivel_int(NIVEL_RELOJ);
+	estadisticas.version=VERSION_ESTADISTICAS;
+	estadisticas.num_listos=num_listos();
+	estadisticas.num_dormidos=longitud_lista(&dormidos);
+	estadisticas.mutex_usados=0;
+	estadisticas.procesos_en_mutex=longitud_lista(&lista_de_mutex);
+	for (i=0; i<num_mut; i++) {
+		if (mutex[i]==NULL)
+			continue;
+		estadisticas.mutex_usados++;
+		estadisticas.procesos_en_mutex+=
+			longitud_lista(&mutex[i]->bloqueados);
+	}
+	estadisticas.num_caches=num_caches;
+	for (i=0; i<num_caches; i++)
+		estadisticas.caches[i]=caches[i].uso;
+
+	if (tam>(int)sizeof(estadisticas))
+		tam=sizeof(estadisticas);
+	memcpy(e, &estadisticas, tam);
+	fijar_nivel_int(nivel);
+	return VERSION_ESTADISTICAS;
+}
+
+/*
+ * Funcion auxiliar que identifica la cola en la que esta bloqueado un
+ * proceso a partir de la lista en la que se inserto.
+ * Return: BLOQ_...; en objeto deja el descriptor con el que el proceso
+ * tiene abierto el objeto por el que espera, el id del proceso que
+ * espera, o -1 si la cola es global
+ */
+static int clasificar_bloqueo(BCP *p_proc, int *objeto){
+	lista_BCPs *lista=p_proc->lista_bloqueo;
+	int i;
+
+	*objeto=-1;
+	if (lista==&dormidos)
+		return BLOQ_DORMIR;
+	if (lista==&lista_de_mutex)
+		return BLOQ_CREAR_MUTEX;
+	for (i=0; i<num_mut; i++)
+		if ((mutex[i]!=NULL) && (lista==&mutex[i]->bloqueados)) {
+			*objeto=descriptor_usuario(p_proc, OBJ_MUTEX, i);
+			return BLOQ_LOCK;
+		}
+	for (i=0; i<NUM_SEM; i++)
+		if ((semaforos[i]!=NULL) && (lista==&semaforos[i]->bloqueados)) {
+			*objeto=descriptor_usuario(p_proc, OBJ_SEM, i);
+			return BLOQ_SEM;
+		}
+	for (i=0; i<NUM_COND; i++)
+		if ((condiciones[i]!=NULL) && (lista==&condiciones[i]->bloqueados)) {
+			*objeto=descriptor_usuario(p_proc, OBJ_COND, i);
+			return BLOQ_COND;
+		}
+	for (i=0; i<NUM_RW; i++)
+		if ((cerrojos_rw[i]!=NULL) && (lista==&cerrojos_rw[i]->bloqueados)) {
+			*objeto=descriptor_usuario(p_proc, OBJ_RW, i);
+			return BLOQ_RW;
+		}
+	for (i=0; i<NUM_COLAS; i++) {
+		if (colas[i]==NULL)
+			continue;
+		if (lista==&colas[i]->esperando_hueco) {
+			*objeto=descriptor_usuario(p_proc, OBJ_COLA, i);
+			return BLOQ_COLA_ENVIAR;
+		}
+		if (lista==&colas[i]->esperando_mensaje) {
+			*objeto=descriptor_usuario(p_proc, OBJ_COLA, i);
+			return BLOQ_COLA_RECIBIR;
+		}
+	}
+	for (i=0; i<MAX_PROC; i++)
+		if (lista==&tabla_procs[i].esperando_fin) {
+			*objeto=i;
+			return BLOQ_ESPERA;
+		}
+	return BLOQ_NINGUNO;
+}
+
+/*
+ * Tratamiento de llamada al sistema listar_procesos. Copia en buf una
+ * foto de como mucho max entradas de la tabla de procesos, tomada con
+ * las interrupciones inhibidas para que sea coherente. Los descriptores
+ * abiertos de todos ellos se copian seguidos en descs, hasta max_descs;
+ * cada entrada indica donde empiezan los suyos y cuantos caben.
+ * Return: numero de entradas copiadas
+ */
+int sis_listar_procesos(){
+	struct info_proceso *buf = (struct info_proceso *)leer_argumento(1);
+	int max = (int)leer_argumento(2);
+	struct info_descriptor *descs = (struct info_descriptor *)leer_argumento(3);
+	int max_descs = (int)leer_argumento(4);
+	struct info_proceso *info;
+	struct recorrido_imagen uso[MAX_PROC];
+	BCP *p_proc;
+	int i, n, d, m;
+	int nivel;
+
+	if ((buf==NULL) || (max<0))
+		return -1;
+	if ((descs==NULL) || (max_descs<0))
+		max_descs=0;
+
+	// Las paginas residentes se cuentan antes, con todo habilitado
+	for (i=0; i<MAX_PROC; i++) {
+		uso[i].paginas=0;
+		uso[i].residentes=0;
+		if (imagenes[i].num_hilos>0)
+			recorrer_imagen(&imagenes[i], &uso[i], 0);
+	}
+
+	nivel = fijar_nivel_int(NIVEL_RELOJ);
+	for (i=0, n=0, m=0; (i<MAX_PROC) && (n<max); i++) {
+		p_proc=&(tabla_procs[i]);
+		if (p_proc->estado==NO_USADA)
+			continue;
+		info=&(buf[n++]);
+		info->id=p_proc->id;
+		info->estado=p_proc->estado;
+		info->padre=p_proc->padre;
+		info->es_hilo=p_proc->es_hilo;
+		info->usuario=p_proc->usuario;
+		info->sistema=p_proc->sistema;
+		info->dormir=((p_proc->estado==BLOQUEADO) &&
+			(p_proc->lista_bloqueo==&dormidos)) ? p_proc->segs : 0;
+		info->primer_desc=m;
+		for (d=siguiente_descriptor(p_proc, 0); (d>=0) && (m<max_descs);
+			d=siguiente_descriptor(p_proc, d+1)) {
+			descs[m].desc=valor_descriptor(p_proc, d);
+			descs[m].tipo=p_proc->descriptores[d].tipo;
+			m++;
+		}
+		info->num_desc=m-info->primer_desc;
+		if (p_proc->estado==BLOQUEADO)
+			info->bloqueo=clasificar_bloqueo(p_proc, &(info->objeto));
+		else {
+			info->bloqueo=BLOQ_NINGUNO;
+			info->objeto=-1;
+		}
+		info->paginas=0;
+		info->residentes=0;
+		if ((p_proc->estado!=ZOMBI) && (p_proc->imagen!=NULL)) {
+			info->paginas=uso[p_proc->imagen-imagenes].paginas;
+			info->residentes=uso[p_proc->imagen-imagenes].residentes;
+		}
+	}
+	fijar_nivel_int(nivel);
+	return n;
+}
+
+/*
+ * Tratamiento de llamada al sistema esperar_proceso. Espera a que
+ * termine un hijo del proceso actual y recoge su estado de salida y
+ * los tiempos de ejecucion que ha consumido.
+ */
+int sis_esperar_proceso(){
+	unsigned int pid = (unsigned int)leer_argumento(1);
+	int *estado = (int *)leer_argumento(2);
+	struct tiempos_ejec *uso = (struct tiempos_ejec *)leer_argumento(3);
+	BCP *p_hijo;
+
+	if (pid >= MAX_PROC) {
+		printk("ERROR: no existe el proceso %d\n", pid);
+		return -1;
+	}
+	p_hijo=&(tabla_procs[pid]);
+	if ((p_hijo->estado==NO_USADA) || p_hijo->es_hilo ||
+		(p_hijo->padre!=p_proc_actual->id)) {
+		printk("ERROR: %d no es hijo del proceso %d\n", pid,
+			p_proc_actual->id);
+		return -1;
+	}
+	if (p_hijo->esperando_fin.primero!=NULL) {
+		printk("ERROR: ya se esta esperando al proceso %d\n", pid);
+		return -1;
+	}
+
+	if (p_hijo->estado!=ZOMBI)
+		bloquear_proceso(&(p_hijo->esperando_fin));
+
+	if (estado!=NULL)
+		*estado=p_hijo->valor_salida;
+	if (uso!=NULL) {
+		uso->usuario=p_hijo->usuario;
+		uso->sistema=p_hijo->sistema;
+	}
+	p_hijo->estado=NO_USADA;
+	return 0;
+}
+
+/*
+ *
+ * Rutina de inicializacin invocada en arranque
+ *
+ */
+int main(){
+	void *marco;
+
+	/* se llega con las interrupciones prohibidas */
+
+	instal_man_int(EXC_ARITM, exc_arit); 
+	instal_man_int(EXC_MEM, exc_mem); 
+	instal_man_int(INT_RELOJ, int_reloj); 
+	instal_man_int(INT_TERMINAL, int_terminal); 
+	instal_man_int(LLAM_SIS, tratar_llamsis); 
+	instal_man_int(INT_SW, int_sw); 
+	tabla_sirq[SIRQ_RELOJ]=reloj_diferido;
+	tabla_sirq[SIRQ_PERFIL]=perfil_diferido;
+
+	iniciar_cont_int();		/* inicia cont. interr. */
+	iniciar_cont_reloj(TICK);	/* fija frecuencia del reloj */
+	iniciar_cont_teclado();		/* inici cont. teclado */
+
+	iniciar_tabla_proc();		/* inicia BCPs de tabla de procesos */
+	iniciar_descriptores();		/* tablas de descriptores */
+
+	cache_mutex=crear_cache("mutex", sizeof(tipo_mutex), construir_mutex);
+	cache_sem=crear_cache("semaforos", sizeof(tipo_semaforo), NULL);
+	cache_cond=crear_cache("condiciones", sizeof(tipo_condicion), NULL);
+	cache_rw=crear_cache("cerrojos_rw", sizeof(tipo_rwlock), NULL);
+	cache_cola=crear_cache("colas", sizeof(tipo_cola), NULL);
+	iniciar_paginas_info();		/* paginas de informacion */
+
+	/* el contexto de arranque pasa a ser el del proceso ocioso */
+	bcp_ocioso.id=ID_OCIOSO;
+	bcp_ocioso.estado=LISTO;
+	bcp_ocioso.padre=-1;
+	p_proc_actual=&bcp_ocioso;
+	registrar_trabajo_ocioso(recoger_pendientes);
+
+	/* la primera llamada a backtrace carga el desenrollador de pila,
+	   reservando memoria; se hace aqui para que muestrear_perfil no lo
+	   haga dentro de la interrupcion de reloj */
+	backtrace(&marco, 1);
+
+	/* crea proceso inicial */
+	if (crear_tarea((void *)"init")<0)
+		panico("no encontrado el proceso inicial");
+	
+	/* activa proceso inicial y se queda como proceso ocioso */
+	bucle_ocioso();
 	panico("S.O. reactivado inesperadamente");
 	return 0;
 }
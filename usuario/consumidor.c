@@ -0,0 +1,47 @@
+/*
+ * usuario/consumidor.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de los semaforos
+ */
+
+#include "servicios.h"
+
+#define NUM_ELEMENTOS 3
+
+int main(){
+	int huecos, datos, i;
+
+	printf("consumidor comienza\n");
+
+	if ((huecos=abrir_sem("huecos"))<0)
+		printf("error abriendo huecos. NO DEBE APARECER\n");
+
+	if ((datos=abrir_sem("datos"))<0)
+		printf("error abriendo datos. NO DEBE APARECER\n");
+
+	for (i=1; i<=NUM_ELEMENTOS; i++) {
+		if (wait_sem(datos)<0)
+			printf("error en wait_sem. NO DEBE APARECER\n");
+
+		printf("consumidor consume el elemento %d\n", i);
+
+		if (signal_sem(huecos)<0)
+			printf("error en signal_sem. NO DEBE APARECER\n");
+	}
+
+	if (cerrar_sem(datos)<0)
+		printf("error cerrando datos. NO DEBE APARECER\n");
+
+	if (cerrar_sem(datos)<0)
+		printf("segundo cierre de datos. DEBE APARECER\n");
+
+	printf("consumidor termina\n");
+	return 0;
+}
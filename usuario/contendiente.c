@@ -0,0 +1,37 @@
+/*
+ * usuario/contendiente.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de contencion de
+ * mutex: toma varias veces el mutex "caliente" y lo retiene un rato.
+ */
+
+#include "servicios.h"
+
+#define VUELTAS 3
+
+int main(){
+	int desc, i;
+
+	if ((desc=abrir_mutex("caliente"))<0) {
+		printf("error abriendo caliente. NO DEBE APARECER\n");
+		return 1;
+	}
+
+	for (i=0; i<VUELTAS; i++) {
+		if (lock(desc)<0)
+			printf("error en lock. NO DEBE APARECER\n");
+		dormir(1);
+		if (unlock(desc)<0)
+			printf("error en unlock. NO DEBE APARECER\n");
+	}
+
+	cerrar_mutex(desc);
+	return 0;
+}
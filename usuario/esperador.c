@@ -0,0 +1,45 @@
+/*
+ * usuario/esperador.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de las variables
+ * condicion
+ */
+
+#include "servicios.h"
+
+int main(){
+	int m, c, id;
+
+	id=obtener_id_pr();
+	printf("esperador (%d) comienza\n", id);
+
+	if ((m=abrir_mutex("mc"))<0)
+		printf("error abriendo mc. NO DEBE APARECER\n");
+
+	if ((c=abrir_cond("c1"))<0)
+		printf("error abriendo c1. NO DEBE APARECER\n");
+
+	if (lock(m)<0)
+		printf("error en lock de mutex. NO DEBE APARECER\n");
+
+	printf("esperador (%d) espera en c1\n", id);
+
+	/* libera mc mientras espera y lo recupera al despertar */
+	if (wait_cond(c, m)<0)
+		printf("error en wait_cond. NO DEBE APARECER\n");
+
+	printf("esperador (%d) despierta con mc bloqueado\n", id);
+
+	if (unlock(m)<0)
+		printf("error en unlock de mutex. NO DEBE APARECER\n");
+
+	printf("esperador (%d) termina\n", id);
+	return 0;
+}
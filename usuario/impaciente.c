@@ -0,0 +1,40 @@
+/*
+ * usuario/impaciente.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de trylock y
+ * lock_timeout: intenta tomar el mutex "ocupado" sin esperar o con plazo.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc;
+
+	printf("impaciente comienza\n");
+
+	if ((desc=abrir_mutex("ocupado"))<0)
+		printf("error abriendo ocupado. NO DEBE APARECER\n");
+
+	if (trylock(desc)<0)
+		printf("impaciente: trylock falla. DEBE APARECER\n");
+
+	if (lock_timeout(desc, 100)<0)
+		printf("impaciente: lock_timeout de 100 ms vence. DEBE APARECER\n");
+
+	/* prueba_trylock lo libera antes de que venza este plazo */
+	if (lock_timeout(desc, 10000)<0)
+		printf("impaciente: lock_timeout de 10 s. NO DEBE APARECER\n");
+	else
+		printf("impaciente: obtiene el mutex\n");
+
+	unlock(desc);
+	printf("impaciente termina\n");
+	return 0;
+}
@@ -12,7 +12,7 @@
  * Fichero de cabecera que contiene los prototipos de funciones de
  * biblioteca que proporcionan la interfaz de llamadas al sistema.
  *
- *      SE DEBE MODIFICAR AL INCLUIR NUEVAS LLAMADAS
+ *      SOLO SE DEBE MODIFICAR AL INCLUIR LLAMADAS DE CLASE MANUAL
  *
  */
 
@@ -22,35 +22,64 @@
 /* Evita el uso del printf de la bilioteca estndar */
 #define printf escribirf
 
-/*
-* Definicin del tipo struct tiempos_ejec
-*/
-struct tiempos_ejec {
-	int usuario;
-	int sistema;
-};
+/* Especificacion de las llamadas al sistema */
+#include "llamsis.h"
+
+/* Tipos y constantes que se intercambian con el ncleo */
+#include "datos_llamsis.h"
 
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 
+#define MODO_COMPETENCIA 0
+#define MODO_CESION 1
+
+#ifndef NULL
+#define NULL (void *) 0
+#endif
+
+#define RW_FIFO 0
+#define RW_PREF_ESCRITORES 1
+
 
 /* Funcion de biblioteca */
 int escribirf(const char *formato, ...);
 
-/* Llamadas al sistema proporcionadas */
-int crear_proceso(char *prog);
+/*
+ * Llamadas al sistema cuya interfaz se genera a partir de su entrada en
+ * llamsis.h. crear_proceso devuelve el id del hijo, que se puede esperar
+ * con esperar_proceso. Un hijo terminado ocupa uno de los pocos BCPs del
+ * sistema hasta que su padre lo espera o termina, por lo que un proceso
+ * que crea hijos y sigue ejecutando debe esperarlos. En perfil, en cada tick en modo usuario se
+ * incrementa buf[desplazamiento/escala]; con buf nulo se desactiva.
+ */
+#define PROTOTIPO_GENERADA(NUMERO, nombre, nargs, parametros, ...) \
+	int nombre parametros;
+#define PROTOTIPO_MANUAL(...)
+#define PROTOTIPO_LLAMADA(clase, ...) PROTOTIPO_##clase(__VA_ARGS__)
+LISTA_LLAMADAS(PROTOTIPO_LLAMADA)
+#undef PROTOTIPO_LLAMADA
+#undef PROTOTIPO_MANUAL
+#undef PROTOTIPO_GENERADA
+
+/* Llamadas al sistema con interfaz escrita a mano en serv.c */
 int terminar_proceso();
-int escribir(char *texto, unsigned int longi);
-
-// Funcionalidad adicional
-int obtener_id_pr();
-int dormir(unsigned int segundos);
-int tiempos_proceso(struct tiempos_ejec *t_ejec);
-int crear_mutex(char*nombre, int tipo);
-int abrir_mutex(char*nombre);
-int lock(unsigned int mutexid);
-int unlock(unsigned int mutexid);
-int cerrar_mutex(unsigned int mutexid);
+/* salir termina con el estado indicado */
+int salir(int estado);
+int obtener_estadisticas(struct estadisticas *e);
+void *crear_memoria_compartida(char*nombre, int tam);
+void *abrir_memoria_compartida(char*nombre);
+int cerrar_memoria_compartida(void *dir);
+int enviar(unsigned int colaid, char *mensaje, int longitud);
+int enviar_nb(unsigned int colaid, char *mensaje, int longitud);
+int recibir(unsigned int colaid, char *buf, int longitud);
+int recibir_nb(unsigned int colaid, char *buf, int longitud);
+int crear_hilo(int (*funcion)(void *), void *arg);
+/* obtener_pagina_info devuelve la pgina del proceso o hilo que llama,
+   que no cambia mientras exista; leerla no supone llamadas al sistema */
+const struct pagina_info *obtener_pagina_info();
+void leer_pagina_info(const struct pagina_info *pag, struct pagina_info *copia);
+unsigned long long leer_ticks(const struct pagina_info *pag);
 //int leer_caracter();
 
 #endif /* SERVICIOS_H */
@@ -23,7 +23,23 @@
 
 #include "servicios.h"
 
+/* Un hijo terminado ocupa su BCP hasta que se le espera, por lo que init
+   guarda los que crea y los espera antes de terminar */
+#define MAX_HIJOS 16
+
+static int hijos[MAX_HIJOS];
+static int num_hijos=0;
+
+static int crear_hijo(char *prog){
+	int pid;
+
+	if (((pid=crear_proceso(prog))>=0) && (num_hijos<MAX_HIJOS))
+		hijos[num_hijos++]=pid;
+	return pid;
+}
+
 int main(){
+	int i;
 
 	printf("init: comienza\n");
 
@@ -31,16 +47,16 @@ int main(){
 FUNCIONALIDAD YA IMPLEMENTADA EN EL MATERIAL DE APOYO. UNA VEZ QUE IMPLEMENTE
 ALGO COMENTE ESTA PARTE Y DESCOMENTE LA PRUEBA CORRESPONDIENTE */
 
-	if (crear_proceso("simplon")<0)
+	if (crear_hijo("simplon")<0)
                 printf("Error creando simplon\n");
 
-	if (crear_proceso("excep_arit")<0)
+	if (crear_hijo("excep_arit")<0)
 		printf("Error creando excep_arit\n");
 
-	if (crear_proceso("excep_mem")<0)
+	if (crear_hijo("excep_mem")<0)
 		printf("Error creando excep_mem\n");
 	
-	if (crear_proceso("noexiste")<0)
+	if (crear_hijo("noexiste")<0)
 		printf("Error creando noexiste\n");
 
 /* FIN PRUEBA INICIAL */
@@ -49,46 +65,134 @@ ALGO COMENTE ESTA PARTE Y DESCOMENTE LA PRUEBA CORRESPONDIENTE */
 {
         int i;
         for (i=1; i<=2; i++)
-                if (crear_proceso("yosoy")<0)
+                if (crear_hijo("yosoy")<0)
                         printf("Error creando yosoy\n");
 }
 */
 
 /* PRUEBA DE LA LLAMADA DORMIR
-	if (crear_proceso("prueba_dormir")<0)
+	if (crear_hijo("prueba_dormir")<0)
 		printf("Error creando prueba_dormir\n");
 */
 
 /* PRUEBA DE LA LLAMADA TIEMPOS_PROCESO
-	if (crear_proceso("prueba_tiempos")<0)
+	if (crear_hijo("prueba_tiempos")<0)
 		printf("Error creando prueba_tiempos\n");
 */
 
 /* PRIMERA PRUEBA DE MUTEX
-	if (crear_proceso("prueba_mutex1")<0)
+	if (crear_hijo("prueba_mutex1")<0)
 		printf("Error creando prueba_mutex1\n");
 */
 
 /* SEGUNDA PRUEBA DE MUTEX
-	if (crear_proceso("prueba_mutex2")<0)
+	if (crear_hijo("prueba_mutex2")<0)
 		printf("Error creando prueba_mutex2\n");
 */
 
+/* PRUEBA DE SEMAFOROS
+	if (crear_hijo("prueba_sem")<0)
+		printf("Error creando prueba_sem\n");
+*/
+
+/* PRUEBA DE VARIABLES CONDICION
+	if (crear_hijo("prueba_cond")<0)
+		printf("Error creando prueba_cond\n");
+*/
+
+/* PRUEBA DE DESCRIPTORES DE OBJETOS DE DISTINTO TIPO
+	if (crear_hijo("prueba_descriptores")<0)
+		printf("Error creando prueba_descriptores\n");
+*/
+
+/* PRUEBA DE CERROJOS DE LECTORES/ESCRITORES
+	if (crear_hijo("prueba_rw")<0)
+		printf("Error creando prueba_rw\n");
+*/
+
+/* PRUEBA DE MEMORIA COMPARTIDA
+	if (crear_hijo("prueba_mem")<0)
+		printf("Error creando prueba_mem\n");
+*/
+
+/* PRUEBA DE COLAS DE MENSAJES
+	if (crear_hijo("prueba_cola")<0)
+		printf("Error creando prueba_cola\n");
+*/
+
+/* PRUEBA DE HILOS
+	if (crear_hijo("prueba_hilos")<0)
+		printf("Error creando prueba_hilos\n");
+*/
+
+/* PRUEBA DE ESPERA DE PROCESOS
+	if (crear_hijo("prueba_espera")<0)
+		printf("Error creando prueba_espera\n");
+*/
+
+/* PRUEBA DE CREACION DE PROCESOS EN LOTE
+	if (crear_hijo("prueba_lote")<0)
+		printf("Error creando prueba_lote\n");
+*/
+
+/* PRUEBA DE PERFILADO
+	if (crear_hijo("prueba_perfil")<0)
+		printf("Error creando prueba_perfil\n");
+*/
+
+/* MONITOR DE ESTADISTICAS DEL SISTEMA
+	if (crear_hijo("monitor")<0)
+		printf("Error creando monitor\n");
+*/
+
+/* LATENCIA DE LAS SECCIONES CON INTERRUPCIONES ENMASCARADAS
+	if (crear_hijo("latencias")<0)
+		printf("Error creando latencias\n");
+*/
+
+/* FOTO DE LA TABLA DE PROCESOS
+	if (crear_hijo("ps")<0)
+		printf("Error creando ps\n");
+*/
+
+/* PRUEBA DE CONTENCION DE MUTEX
+	if (crear_hijo("prueba_contencion")<0)
+		printf("Error creando prueba_contencion\n");
+*/
+
+/* PRUEBA DE TRYLOCK Y LOCK_TIMEOUT
+	if (crear_hijo("prueba_trylock")<0)
+		printf("Error creando prueba_trylock\n");
+*/
+
+/* PRUEBA DE LOS MODOS DE ENTREGA DE MUTEX
+	if (crear_hijo("prueba_pingpong")<0)
+		printf("Error creando prueba_pingpong\n");
+*/
+
+/* PRUEBA DE LA PAGINA DE INFORMACION DEL NUCLEO
+	if (crear_hijo("prueba_pagina")<0)
+		printf("Error creando prueba_pagina\n");
+*/
+
 /* PRIMERA PRUEBA DE ROUND-ROBIN
-	if (crear_proceso("prueba_RR1")<0)
+	if (crear_hijo("prueba_RR1")<0)
 		printf("Error creando prueba_RR1\n");
 */
 
 /* SEGUNDA PRUEBA DE ROUND-ROBIN
-	if (crear_proceso("prueba_RR2")<0)
+	if (crear_hijo("prueba_RR2")<0)
 		printf("Error creando prueba_RR2\n");
 */
 
 /* PRUEBA DEL TERMINAL
-	if (crear_proceso("prueba_term")<0)
+	if (crear_hijo("prueba_term")<0)
 		printf("Error creando prueba_term\n");
 */
 
+	for (i=0; i<num_hijos; i++)
+		esperar_proceso(hijos[i], NULL, NULL);
+
 	printf("init: termina\n");
 	return 0; 
 }
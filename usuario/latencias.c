@@ -0,0 +1,52 @@
+/*
+ * usuario/latencias.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que muestra cunto tiempo mantiene el ncleo las
+ * interrupciones enmascaradas: los sitios con la seccin ms larga y el
+ * histograma de duraciones. Crea algo de carga para que haya datos.
+ */
+
+#include "servicios.h"
+
+int main(){
+	struct latencias l;
+	struct sitio_latencia *s;
+	int i;
+
+	printf("latencias comienza\n");
+
+	if (crear_proceso("simplon")<0)
+		printf("Error creando simplon\n");
+	if (crear_proceso("dormilon")<0)
+		printf("Error creando dormilon\n");
+	dormir(2);
+
+	if (obtener_latencias(&l)<0) {
+		printf("error en obtener_latencias. NO DEBE APARECER\n");
+		return 1;
+	}
+
+	printf("secciones %d sitios %d (perdidas %d)\n", l.secciones,
+		l.sitios, l.sitios_perdidos);
+	for (i=0; i<l.num_puestos; i++) {
+		s=&l.puestos[i];
+		printf("%d. %s:%d veces %d max %lld ns media %lld ns\n", i+1,
+			s->funcion, s->linea, s->veces, s->max_ns,
+			s->total_ns/s->veces);
+	}
+	printf("histograma (us):");
+	for (i=0; i<NUM_CUBETAS_LATENCIA; i++)
+		if (l.histograma[i]>0)
+			printf(" <%d:%d", 1<<i, l.histograma[i]);
+	printf("\n");
+
+	printf("latencias termina\n");
+	return 0;
+}
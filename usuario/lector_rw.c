@@ -0,0 +1,37 @@
+/*
+ * usuario/lector_rw.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de los cerrojos de
+ * lectores/escritores
+ */
+
+#include "servicios.h"
+
+int main(){
+	int rw, id;
+
+	id=obtener_id_pr();
+	printf("lector_rw (%d) comienza\n", id);
+
+	if ((rw=abrir_rw("conf"))<0)
+		printf("error abriendo conf. NO DEBE APARECER\n");
+
+	if (lock_lectura(rw)<0)
+		printf("error en lock_lectura. NO DEBE APARECER\n");
+
+	printf("lector_rw (%d) lee y duerme 1 seg. con el cerrojo: el otro lector tambien debe poder leer\n", id);
+	dormir(1);
+
+	if (unlock_rw(rw)<0)
+		printf("error en unlock_rw. NO DEBE APARECER\n");
+
+	printf("lector_rw (%d) termina\n", id);
+	return 0;
+}
@@ -12,7 +12,7 @@
  * Fichero que contiene las definiciones de las funciones de interfaz
  * a las llamadas al sistema. Usa la funcion de apoyo llamsis
  *
- *      SE DEBE MODIFICAR AL INCLUIR NUEVAS LLAMADAS
+ *      SOLO SE DEBE MODIFICAR AL INCLUIR LLAMADAS DE CLASE MANUAL
  *
  */
 
@@ -34,38 +34,133 @@ int llamsis(int llamada, int nargs, ... /* args */);
  */
 
 
-int crear_proceso(char *prog){
-	return llamsis(CREAR_PROCESO, 1, (long)prog);
+/*
+ * Funciones de las llamadas de clase GENERADA en llamsis.h: cada una
+ * pasa sus nargs parametros convertidos a long
+ */
+#define ARGS_0()
+#define ARGS_1(a) , (long)(a)
+#define ARGS_2(a, b) ARGS_1(a) ARGS_1(b)
+#define ARGS_3(a, b, c) ARGS_2(a, b) ARGS_1(c)
+#define ARGS_4(a, b, c, d) ARGS_3(a, b, c) ARGS_1(d)
+#define ARGS_5(a, b, c, d, e) ARGS_4(a, b, c, d) ARGS_1(e)
+
+#define FUNCION_GENERADA(NUMERO, nombre, nargs, parametros, ...) \
+int nombre parametros { \
+	return llamsis(NUMERO, nargs ARGS_##nargs(__VA_ARGS__)); \
 }
+#define FUNCION_MANUAL(...)
+#define FUNCION_LLAMADA(clase, ...) FUNCION_##clase(__VA_ARGS__)
+LISTA_LLAMADAS(FUNCION_LLAMADA)
+
+/*
+ * Funciones de las llamadas de clase MANUAL
+ */
 int terminar_proceso(){
-	return llamsis(TERMINAR_PROCESO, 0);
+	return llamsis(TERMINAR_PROCESO, 1, 0L);
 }
-int escribir(char *texto, unsigned int longi){
-	return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
+int salir(int estado){
+	return llamsis(TERMINAR_PROCESO, 1, (long)estado);
 }
-int obtener_id_pr() {
-	return llamsis(OBTENER_ID_PR, 0);
+void *crear_memoria_compartida(char*nombre, int tam) {
+	void *dir;
+
+	if (llamsis(CREAR_MEM_COMP, 3, (long)nombre, (long) tam, (long)&dir)<0)
+		return NULL;
+	return dir;
+}
+void *abrir_memoria_compartida(char*nombre) {
+	void *dir;
+
+	if (llamsis(ABRIR_MEM_COMP, 2, (long)nombre, (long)&dir)<0)
+		return NULL;
+	return dir;
 }
-int dormir(unsigned int segundos) {
-	return llamsis(DORMIR, 1, (long)segundos);
+int cerrar_memoria_compartida(void *dir) {
+	return llamsis(CERRAR_MEM_COMP, 1, (long)dir);
 }
-int tiempos_proceso(struct tiempos_ejec *t_ejec) {
-	return llamsis(TIEMPOS_PROCESO, 0);
+int enviar(unsigned int colaid, char *mensaje, int longitud) {
+	return llamsis(ENVIAR, 4, (long) colaid, (long)mensaje,
+			(long) longitud, 0L);
 }
-int crear_mutex(char*nombre, int tipo) {
-	return llamsis(CREAR_MUTEX, 2, (long)nombre, (long) tipo);
+int enviar_nb(unsigned int colaid, char *mensaje, int longitud) {
+	return llamsis(ENVIAR, 4, (long) colaid, (long)mensaje,
+			(long) longitud, 1L);
 }
-int abrir_mutex(char*nombre) {
-	return llamsis(ABRIR_MUTEX, 1, (long)nombre);
+int recibir(unsigned int colaid, char *buf, int longitud) {
+	return llamsis(RECIBIR, 4, (long) colaid, (long)buf,
+			(long) longitud, 0L);
 }
-int lock(unsigned int mutexid) {
-	return llamsis(LOCK, 1, (long) mutexid);
+int recibir_nb(unsigned int colaid, char *buf, int longitud) {
+	return llamsis(RECIBIR, 4, (long) colaid, (long)buf,
+			(long) longitud, 1L);
 }
-int unlock(unsigned int mutexid) {
-	return llamsis(UNLOCK, 1, (long) mutexid);
+
+/* Punto de entrada de todos los hilos: obtiene del nucleo la funcion y
+   el argumento con los que se creo el hilo y termina con su valor */
+static void inicio_hilo() {
+	int (*funcion)(void *);
+	void *arg;
+
+	llamsis(DATOS_HILO, 2, (long)&funcion, (long)&arg);
+	terminar_hilo(funcion(arg));
 }
-int cerrar_mutex(unsigned int mutexid) {
-	return llamsis(CERRAR_MUTEX, 1, (long) mutexid);
+/* Punto de entrada de los procesos: el nucleo arranca aqui en lugar de
+   en main, que obtiene con datos_hilo, para que lo que devuelva sea el
+   estado de salida */
+void inicio_proceso() {
+	int (*funcion)(void *);
+	void *arg;
+
+	llamsis(DATOS_HILO, 2, (long)&funcion, (long)&arg);
+	salir(funcion(arg));
+}
+int crear_hilo(int (*funcion)(void *), void *arg) {
+	return llamsis(CREAR_HILO, 3, (long)inicio_hilo, (long)funcion,
+			(long)arg);
+}
+int obtener_estadisticas(struct estadisticas *e) {
+	return llamsis(OBTENER_ESTADISTICAS, 2, (long)e, (long)sizeof(*e));
+}
+const struct pagina_info *obtener_pagina_info() {
+	const struct pagina_info *pag;
+
+	if (llamsis(OBTENER_PAGINA_INFO, 1, (long)&pag)<0)
+		return NULL;
+	return pag;
+}
+
+/* Copia coherente de la pagina: si la secuencia era impar o cambio
+   durante la copia, el nucleo la estaba modificando y se repite */
+void leer_pagina_info(const struct pagina_info *pag, struct pagina_info *copia) {
+	const volatile struct pagina_info *p = pag;
+	unsigned int sec;
+
+	do {
+		sec = p->secuencia;
+		__sync_synchronize();
+		copia->id = p->id;
+		copia->ticks = p->ticks;
+		copia->reloj_base = p->reloj_base;
+		copia->ticks_por_seg = p->ticks_por_seg;
+		copia->usuario = p->usuario;
+		copia->sistema = p->sistema;
+		__sync_synchronize();
+	} while ((sec & 1) || (sec != p->secuencia));
+	copia->secuencia = sec;
+}
+unsigned long long leer_ticks(const struct pagina_info *pag) {
+	const volatile struct pagina_info *p = pag;
+	unsigned long long ticks;
+	unsigned int sec;
+
+	do {
+		sec = p->secuencia;
+		__sync_synchronize();
+		ticks = p->ticks;
+		__sync_synchronize();
+	} while ((sec & 1) || (sec != p->secuencia));
+	return ticks;
 }
 /*int leer_caracter() {
 	return llamsis(LEER_CARACTER, 0);
@@ -0,0 +1,70 @@
+/*
+ * usuario/monitor.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que muestra periodicamente las estadisticas del
+ * sistema, al estilo de top. Crea algo de carga para que haya datos.
+ */
+
+#include "servicios.h"
+
+#define MUESTRAS 5
+
+/* imprime una carga media en coma fija con dos decimales */
+static void imprimir_carga(int carga){
+	printf(" %d.%d%d", carga/FIJO_1, (carga%FIJO_1)*10/FIJO_1,
+		(carga%FIJO_1)*100/FIJO_1%10);
+}
+
+int main(){
+	struct estadisticas e;
+	struct uso_cache *c;
+	int i, j, version;
+
+	printf("monitor comienza\n");
+
+	if (crear_proceso("simplon")<0)
+		printf("Error creando simplon\n");
+	if (crear_proceso("dormilon")<0)
+		printf("Error creando dormilon\n");
+
+	for (i=0; i<MUESTRAS; i++) {
+		if ((version=obtener_estadisticas(&e))<0) {
+			printf("error en obtener_estadisticas. NO DEBE APARECER\n");
+			break;
+		}
+		if (version!=VERSION_ESTADISTICAS)
+			printf("monitor: version %d del nucleo\n", version);
+
+		printf("carga:");
+		imprimir_carga(e.carga[0]);
+		imprimir_carga(e.carga[1]);
+		imprimir_carga(e.carga[2]);
+		printf("  listos %d dormidos %d\n", e.num_listos, e.num_dormidos);
+		printf("ticks: usuario %d sistema %d ocioso %d\n",
+			e.ticks_usuario, e.ticks_sistema, e.ticks_ocioso);
+		printf("cambios: bloqueo %d dormir %d mutex %d fin %d ocioso %d\n",
+			e.cambios[CAMBIO_BLOQUEO], e.cambios[CAMBIO_DORMIR],
+			e.cambios[CAMBIO_MUTEX], e.cambios[CAMBIO_FIN],
+			e.cambios[CAMBIO_OCIOSO]);
+		printf("llamadas %d creados %d terminados %d mutex %d (esperan %d)\n",
+			e.llamadas, e.procesos_creados, e.procesos_terminados,
+			e.mutex_usados, e.procesos_en_mutex);
+		for (j=0; j<e.num_caches; j++) {
+			c=&e.caches[j];
+			printf("cache %s: tam %d slabs %d objetos %d en uso %d (max %d) fallos %d\n",
+				c->nombre, c->tam_objeto, c->slabs, c->objetos,
+				c->en_uso, c->max_en_uso, c->fallos);
+		}
+		dormir(1);
+	}
+
+	printf("monitor termina\n");
+	return 0;
+}
@@ -0,0 +1,21 @@
+#!/bin/sh
+#
+# usuario/perfil.sh
+#	Traduce a funciones las muestras de perfilado que imprime un
+#	programa de usuario (lineas "PERFIL desplazamiento muestras") usando
+#	addr2line sobre su ejecutable, y las suma por funcion.
+#
+# Uso: sh perfil.sh programa < salida_del_minikernel
+#
+
+if [ $# -ne 1 ]; then
+	echo "uso: $0 programa < salida" >&2
+	exit 1
+fi
+
+grep '^PERFIL ' | while read etiqueta desp muestras; do
+	funcion=`addr2line -f -e "$1" \`printf '%x' $desp\` | head -1`
+	echo "$muestras $funcion"
+done | awk '{ total[$2]+=$1; suma+=$1 }
+	END { for (f in total) printf "%6d %5.1f%% %s\n", total[f], 100*total[f]/suma, f }' |
+	sort -rn
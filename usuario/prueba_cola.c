@@ -0,0 +1,49 @@
+/*
+ * usuario/prueba_cola.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de las colas de mensajes.
+ * Envia mensajes al proceso receptor a traves de una cola de capacidad 2.
+ */
+
+#include "servicios.h"
+
+#define NUM_MENSAJES 4
+
+int main(){
+	int cola, i;
+	char mensaje[16];
+	char buf[16];
+
+	printf("prueba_cola comienza\n");
+
+	if ((cola=crear_cola("tuberia", 2, sizeof(mensaje)))<0)
+		printf("error creando tuberia. NO DEBE APARECER\n");
+
+	if (crear_cola("otra", 0, sizeof(mensaje))<0)
+		printf("error creando cola sin capacidad. DEBE APARECER\n");
+
+	/* cola vacia: la recepcion no bloqueante falla */
+	if (recibir_nb(cola, buf, sizeof(buf))<0)
+		printf("recibir_nb con la cola vacia. DEBE APARECER\n");
+
+	if (crear_proceso("receptor")<0)
+		printf("Error creando receptor\n");
+
+	for (i=0; i<NUM_MENSAJES; i++) {
+		mensaje[0]='a'+i;
+		mensaje[1]='\0';
+		printf("prueba_cola envia %s: se bloquea si la cola esta llena\n", mensaje);
+		if (enviar(cola, mensaje, 2)<0)
+			printf("error en enviar. NO DEBE APARECER\n");
+	}
+
+	printf("prueba_cola termina\n");
+	return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * usuario/prueba_cond.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de las variables condicion
+ */
+
+#include "servicios.h"
+
+int main(){
+	int m, c;
+
+	printf("prueba_cond comienza\n");
+
+	if ((m=crear_mutex("mc", NO_RECURSIVO))<0)
+		printf("error creando mc. NO DEBE APARECER\n");
+
+	if ((c=crear_cond("c1"))<0)
+		printf("error creando c1. NO DEBE APARECER\n");
+
+	/* wait_cond sin tener bloqueado el mutex -> error */
+	if (wait_cond(c, m)<0)
+		printf("wait_cond sin tener el mutex. DEBE APARECER\n");
+
+	if (crear_proceso("esperador")<0)
+		printf("Error creando esperador\n");
+
+	if (crear_proceso("esperador")<0)
+		printf("Error creando esperador\n");
+
+	printf("prueba_cond duerme 1 seg.: los esperadores se bloquearan en c1\n");
+	dormir(1);
+
+	if (lock(m)<0)
+		printf("error en lock de mutex. NO DEBE APARECER\n");
+
+	/* Debe despertar solo al primer esperador */
+	if (signal_cond(c)<0)
+		printf("error en signal_cond. NO DEBE APARECER\n");
+
+	if (unlock(m)<0)
+		printf("error en unlock de mutex. NO DEBE APARECER\n");
+
+	printf("prueba_cond duerme 1 seg.: debe ejecutar solo el primer esperador\n");
+	dormir(1);
+
+	/* Debe despertar al resto de esperadores */
+	if (broadcast_cond(c)<0)
+		printf("error en broadcast_cond. NO DEBE APARECER\n");
+
+	printf("prueba_cond termina: debe ejecutar el segundo esperador\n");
+	return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * usuario/prueba_contencion.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los contadores de
+ * contencion de mutex. Dos procesos contendiente se disputan el mutex
+ * "caliente", mientras que "frio" solo lo usa este programa.
+ */
+
+#include "servicios.h"
+
+#define NUM_HIJOS 2
+#define MAX_MUTEX 16
+
+int main(){
+	struct info_mutex info[MAX_MUTEX];
+	int pids[NUM_HIJOS];
+	int caliente, frio, i, n;
+	struct contencion_mutex *c;
+
+	printf("prueba_contencion comienza\n");
+
+	if ((caliente=crear_mutex("caliente", NO_RECURSIVO))<0)
+		printf("error creando caliente. NO DEBE APARECER\n");
+	if ((frio=crear_mutex("frio", RECURSIVO))<0)
+		printf("error creando frio. NO DEBE APARECER\n");
+
+	/* frio: anidado y sin contencion */
+	lock(frio);
+	lock(frio);
+	unlock(frio);
+	unlock(frio);
+
+	if (crear_procesos("contendiente", NUM_HIJOS, pids)<0)
+		printf("error creando contendientes. NO DEBE APARECER\n");
+	for (i=0; i<NUM_HIJOS; i++)
+		esperar_proceso(pids[i], NULL, NULL);
+
+	n=listar_mutex(info, MAX_MUTEX);
+	for (i=0; i<n; i++) {
+		c=&info[i].contencion;
+		printf("%s: adq %d contendidas %d espera %d (max %d) retencion %d (max %d) profundidad %d\n",
+			info[i].nombre, c->adquisiciones, c->contendidas,
+			c->espera_total, c->espera_max, c->retencion_total,
+			c->retencion_max, c->profundidad_max);
+	}
+
+	printf("prueba_contencion termina\n");
+	return 0;
+}
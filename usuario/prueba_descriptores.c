@@ -0,0 +1,59 @@
+/*
+ * usuario/prueba_descriptores.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mezcla en un mismo proceso objetos de todos
+ * los tipos, de forma que la posicin de cada descriptor no coincide
+ * con el nmero del objeto en el ncleo, y comprueba que cada uno se
+ * usa a travs del descriptor que devolvi su creacin o apertura.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int m, s, s2, c, rw, q;
+	char msj[4];
+
+	printf("prueba_descriptores comienza\n");
+
+	if ((m=crear_mutex("md", NO_RECURSIVO))<0)
+		printf("error creando md. NO DEBE APARECER\n");
+	if ((s=crear_sem("sd", 0))<0)
+		printf("error creando sd. NO DEBE APARECER\n");
+	if ((c=crear_cond("cd"))<0)
+		printf("error creando cd. NO DEBE APARECER\n");
+	if ((rw=crear_rw("rwd", RW_FIFO))<0)
+		printf("error creando rwd. NO DEBE APARECER\n");
+	if ((q=crear_cola("qd", 2, sizeof(msj)))<0)
+		printf("error creando qd. NO DEBE APARECER\n");
+
+	if ((lock(m)<0) || (signal_cond(c)<0) || (unlock(m)<0))
+		printf("error usando md y cd. NO DEBE APARECER\n");
+	if ((signal_sem(s)<0) || (wait_sem(s)<0))
+		printf("error usando sd. NO DEBE APARECER\n");
+	if ((lock_lectura(rw)<0) || (unlock_rw(rw)<0))
+		printf("error usando rwd. NO DEBE APARECER\n");
+	if ((enviar_nb(q, "abc", sizeof(msj))<0) ||
+		(recibir_nb(q, msj, sizeof(msj))<0))
+		printf("error usando qd. NO DEBE APARECER\n");
+
+	/* una segunda apertura ocupa otra posicion; al cerrar la primera
+	   su descriptor deja de valer aunque el semaforo siga existiendo */
+	if ((s2=abrir_sem("sd"))<0)
+		printf("error abriendo sd. NO DEBE APARECER\n");
+	if (cerrar_sem(s)<0)
+		printf("error cerrando sd. NO DEBE APARECER\n");
+	if (signal_sem(s)<0)
+		printf("signal_sem con descriptor cerrado. DEBE APARECER\n");
+	if ((signal_sem(s2)<0) || (wait_sem(s2)<0))
+		printf("error usando sd reabierto. NO DEBE APARECER\n");
+
+	printf("prueba_descriptores termina\n");
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * usuario/prueba_espera.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de esperar_proceso. Crea
+ * varios hijos y recoge su estado de salida en cuanto terminan, sin
+ * necesidad de dormir.
+ */
+
+#include "servicios.h"
+
+#define NUM_HIJOS 3
+
+char *programas[NUM_HIJOS]={"simplon", "saliente", "excep_arit"};
+
+int main(){
+	int hijos[NUM_HIJOS];
+	int i, estado;
+	struct tiempos_ejec uso;
+
+	printf("prueba_espera comienza\n");
+
+	for (i=0; i<NUM_HIJOS; i++)
+		if ((hijos[i]=crear_proceso(programas[i]))<0)
+			printf("Error creando %s\n", programas[i]);
+
+	for (i=0; i<NUM_HIJOS; i++)
+		if (esperar_proceso(hijos[i], &estado, &uso)<0)
+			printf("error esperando a %s. NO DEBE APARECER\n",
+				programas[i]);
+		else
+			printf("%s (%d) termina con estado %d; usuario %d sistema %d\n",
+				programas[i], hijos[i], estado,
+				uso.usuario, uso.sistema);
+
+	/* ya recogido: no se puede esperar de nuevo */
+	if (esperar_proceso(hijos[0], &estado, &uso)<0)
+		printf("esperar un hijo ya recogido. DEBE APARECER\n");
+
+	printf("prueba_espera termina\n");
+	return 0;
+}
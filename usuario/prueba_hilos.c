@@ -0,0 +1,60 @@
+/*
+ * usuario/prueba_hilos.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los hilos. Crea dos
+ * hilos que comparten la imagen del proceso: cada uno acumula en una
+ * variable global y devuelve su resultado, que se recoge con esperar_hilo.
+ */
+
+#include "servicios.h"
+
+#define NUM_HILOS 2
+#define VUELTAS 100
+
+/* variable global visible por todos los hilos del proceso */
+int acumulado[NUM_HILOS];
+
+static int trabajador(void *arg){
+	int n=(long)arg;
+	int i;
+
+	printf("hilo %d comienza\n", n);
+	for (i=0; i<VUELTAS; i++)
+		acumulado[n]+=n+1;
+	dormir(1);
+	printf("hilo %d termina\n", n);
+	return acumulado[n];
+}
+
+int main(){
+	int hilos[NUM_HILOS];
+	int i, valor;
+
+	printf("prueba_hilos comienza\n");
+
+	for (i=0; i<NUM_HILOS; i++)
+		if ((hilos[i]=crear_hilo(trabajador, (void *)(long)i))<0)
+			printf("error creando hilo %d. NO DEBE APARECER\n", i);
+
+	for (i=0; i<NUM_HILOS; i++) {
+		if (esperar_hilo(hilos[i], &valor)<0)
+			printf("error esperando hilo %d. NO DEBE APARECER\n", i);
+		else
+			printf("hilo %d devuelve %d; global %d (debe ser %d)\n",
+				i, valor, acumulado[i], VUELTAS*(i+1));
+	}
+
+	/* ya recogido: no se puede esperar de nuevo */
+	if (esperar_hilo(hilos[0], &valor)<0)
+		printf("esperar un hilo ya recogido. DEBE APARECER\n");
+
+	printf("prueba_hilos termina\n");
+	return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * usuario/prueba_lote.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de crear_procesos. Crea
+ * un lote de procesos con una sola llamada y espera a que terminen.
+ */
+
+#include "servicios.h"
+
+#define NUM_HIJOS 3
+
+int main(){
+	int pids[20];
+	int i, estado;
+
+	printf("prueba_lote comienza\n");
+
+	if (crear_procesos("saliente", NUM_HIJOS, pids)<0)
+		printf("error creando el lote. NO DEBE APARECER\n");
+	else
+		for (i=0; i<NUM_HIJOS; i++) {
+			esperar_proceso(pids[i], &estado, NULL);
+			printf("hijo %d termina con estado %d\n", pids[i], estado);
+		}
+
+	/* no caben: no se crea ninguno */
+	if (crear_procesos("saliente", 20, pids)<0)
+		printf("error creando 20 procesos. DEBE APARECER\n");
+
+	/* programa inexistente: no se crea ninguno */
+	if (crear_procesos("no_existe", 2, pids)<0)
+		printf("error creando no_existe. DEBE APARECER\n");
+
+	printf("prueba_lote termina\n");
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * usuario/prueba_mem.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de la memoria compartida.
+ * Deja un mensaje en una region compartida que lee el proceso visor_mem
+ * sin que los datos pasen por el kernel.
+ */
+
+#include "servicios.h"
+
+int main(){
+	char *region;
+	char *mensaje="dato compartido";
+	int listo, i;
+
+	printf("prueba_mem comienza\n");
+
+	if ((region=crear_memoria_compartida("reg", 1024))==NULL)
+		printf("error creando reg. NO DEBE APARECER\n");
+
+	if (crear_memoria_compartida("reg", 1024)==NULL)
+		printf("error creando reg por segunda vez. DEBE APARECER\n");
+
+	if (crear_memoria_compartida("grande", 1<<20)==NULL)
+		printf("error creando region demasiado grande. DEBE APARECER\n");
+
+	if ((listo=crear_sem("listo", 0))<0)
+		printf("error creando listo. NO DEBE APARECER\n");
+
+	if (crear_proceso("visor_mem")<0)
+		printf("Error creando visor_mem\n");
+
+	printf("prueba_mem duerme 1 seg.: visor_mem abrira reg y esperara en listo\n");
+	dormir(1);
+
+	for (i=0; mensaje[i]; i++)
+		region[i]=mensaje[i];
+	region[i]='\0';
+
+	printf("prueba_mem ha escrito el mensaje en reg\n");
+
+	/* debe despertar a visor_mem */
+	signal_sem(listo);
+
+	if (cerrar_memoria_compartida(region)<0)
+		printf("error cerrando reg. NO DEBE APARECER\n");
+
+	if (cerrar_memoria_compartida(region)<0)
+		printf("segundo cierre de reg. DEBE APARECER\n");
+
+	printf("prueba_mem termina\n");
+	return 0;
+}
@@ -9,30 +9,31 @@
 
 /*
  * Programa de usuario que realiza una prueba de las llamadas crear,
- * abrir y cerrar de mutex
+ * abrir y cerrar de mutex. Espera a sus hijos para que no queden como
+ * zombis ocupando entradas de la tabla de procesos.
  */
 
 #include "servicios.h"
 
-int main(){
+#define NUM_HIJOS 5
+
+char *programas[NUM_HIJOS]={"creador1", "creador2", "creador3",
+	"creador4", "abridor"};
 
+int main(){
+	int hijos[NUM_HIJOS];
+	int i;
 
 	printf("prueba_mutex1: comienza\n");
 
-	if (crear_proceso("creador1")<0)
-		printf("Error creando creador1\n");
-	
-	if (crear_proceso("creador2")<0)
-		printf("Error creando creador2\n");
-	
-	if (crear_proceso("creador3")<0)
-		printf("Error creando creador3\n");
-	
-	if (crear_proceso("creador4")<0)
-		printf("Error creando creador4\n");
-	
-	if (crear_proceso("abridor")<0)
-		printf("Error creando abridor\n");
+	for (i=0; i<NUM_HIJOS; i++)
+		if ((hijos[i]=crear_proceso(programas[i]))<0)
+			printf("Error creando %s\n", programas[i]);
+
+	for (i=0; i<NUM_HIJOS; i++)
+		if ((hijos[i]>=0) && (esperar_proceso(hijos[i], NULL, NULL)<0))
+			printf("error esperando a %s. NO DEBE APARECER\n",
+				programas[i]);
 
 	printf("prueba_mutex1: termina\n");
 	return 0; 
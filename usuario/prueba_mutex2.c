@@ -16,6 +16,7 @@
 
 int main(){
 	int desc1, desc2;
+	int hijo1;
 
 	printf("prueba_mutex comienza\n");
 
@@ -43,7 +44,7 @@ int main(){
 	if (lock(desc2)<0)
 		printf("error en lock de mutex. NO DEBE APARECER\n");
 
-	if (crear_proceso("mutex1")<0)
+	if ((hijo1=crear_proceso("mutex1"))<0)
 		printf("Error creando mutex1\n");
 
 	if (crear_proceso("mutex2")<0)
@@ -66,7 +67,12 @@ int main(){
 	printf("prueba_mutex duerme 1 seg.: debe ejecutar mutex1 ya que se ha liberado el mutex m2\n");
 	dormir(1);
 
-	printf("prueba_mutex termina: debe ejecutar mutex2 ya que el cierre implcito de m1 debe despertarlo y mutex1 est dormido\n");
+	/* se recoge a mutex1 para que no quede como zombi; mutex2 sigue
+	   bloqueado en m1 y termina ya huerfano */
+	if ((hijo1>=0) && (esperar_proceso(hijo1, NULL, NULL)<0))
+		printf("error esperando a mutex1. NO DEBE APARECER\n");
+
+	printf("prueba_mutex termina: debe ejecutar mutex2 ya que el cierre implcito de m1 debe despertarlo y mutex1 ya ha terminado\n");
 
 	/* cierre implcito de semforos: debe despertar a mutex2 */
 	return 0;
@@ -0,0 +1,56 @@
+/*
+ * usuario/prueba_pagina.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la pgina de informacin del ncleo:
+ * compara sus datos con los de las llamadas equivalentes, mide un bucle
+ * leyendo el tick sin llamadas y por ltimo intenta escribir en ella,
+ * lo que debe provocar una excepcin de memoria.
+ */
+
+#include "servicios.h"
+
+#define TOT_ITER 200000	/* ponga las que considere oportuno */
+
+int main(){
+	const struct pagina_info *pag;
+	struct pagina_info info;
+	struct tiempos_ejec t;
+	unsigned long long inicio, fin;
+	int i, id;
+
+	id=obtener_id_pr();
+	if ((pag=obtener_pagina_info())==NULL) {
+		printf("prueba_pagina (%d): error obteniendo la pagina\n", id);
+		return 1;
+	}
+
+	leer_pagina_info(pag, &info);
+	printf("prueba_pagina (%d): pagina id %d ticks %llu (%d por seg) reloj base %llu\n",
+		id, info.id, info.ticks, info.ticks_por_seg, info.reloj_base);
+	if (info.id!=id)
+		printf("prueba_pagina (%d): ERROR el id no coincide\n", id);
+
+	inicio=leer_ticks(pag);
+	for (i=0; i<TOT_ITER; i++)
+		fin=leer_ticks(pag);
+	printf("prueba_pagina (%d): %d lecturas del tick en %llu ticks\n",
+		id, TOT_ITER, fin-inicio);
+
+	tiempos_proceso(&t);
+	leer_pagina_info(pag, &info);
+	printf("prueba_pagina (%d): llamada usuario %d sistema %d; pagina usuario %d sistema %d\n",
+		id, t.usuario, t.sistema, info.usuario, info.sistema);
+
+	printf("prueba_pagina (%d): escribe en la pagina (debe morir)\n", id);
+	((struct pagina_info *)pag)->id=0;
+
+	printf("prueba_pagina (%d): ERROR la pagina admite escrituras\n", id);
+	return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * usuario/prueba_perfil.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba del perfilado estadistico.
+ * Imprime las celdas con muestras como lineas "PERFIL desplazamiento
+ * muestras", que perfil.sh traduce a funciones con addr2line:
+ *
+ *	sh perfil.sh prueba_perfil < salida
+ */
+
+#include "servicios.h"
+
+#define ESCALA 4		/* bytes de codigo por celda */
+#define CELDAS 4096		/* cubre los primeros 16KB del programa */
+
+unsigned int histograma[CELDAS];
+
+volatile int acumulado;
+
+static void trabajo_corto(){
+	int i;
+
+	for (i=0; i<1000000; i++)
+		acumulado+=i;
+}
+
+static void trabajo_largo(){
+	int i;
+
+	for (i=0; i<4000000; i++)
+		acumulado+=i;
+}
+
+int main(){
+	int i, vueltas;
+
+	printf("prueba_perfil comienza\n");
+
+	if (perfil(histograma, 0, ESCALA)<0)
+		printf("error activando perfil sin celdas. DEBE APARECER\n");
+
+	if (perfil(histograma, CELDAS, ESCALA)<0)
+		printf("error activando perfil. NO DEBE APARECER\n");
+
+	for (vueltas=0; vueltas<10; vueltas++) {
+		trabajo_corto();
+		trabajo_largo();
+	}
+	perfil(NULL, 0, 0);
+
+	for (i=0; i<CELDAS; i++)
+		if (histograma[i]>0)
+			printf("PERFIL %d %d\n", i*ESCALA, histograma[i]);
+
+	printf("prueba_perfil termina\n");
+	return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * usuario/prueba_pingpong.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que compara los dos modos de entrega de un mutex.
+ * Este programa y rebote se pasan el mutex "pingpong" ITERACIONES veces,
+ * primero en MODO_COMPETENCIA y despues en MODO_CESION. Los semaforos
+ * "ping" y "pong" imponen el turno: cada uno suelta el mutex solo cuando
+ * el otro va a pedirlo, y no vuelve a pedirlo hasta que el otro lo tiene,
+ * de modo que en ambos modos el mutex cambia de manos en cada pasada.
+ * Se muestran los cambios de contexto por pasada y el tiempo por pasada
+ * medido con el contador de ticks de la pagina de informacion.
+ */
+
+#include "servicios.h"
+
+#define ITERACIONES 10000
+
+/*
+ * Entrega el mutex, que se tiene, al otro proceso y espera a recuperarlo
+ */
+static void pasar(int mutex, int mi_turno, int su_turno){
+	wait_sem(mi_turno);	/* el otro va a pedir el mutex */
+	unlock(mutex);
+	wait_sem(mi_turno);	/* el otro ya lo tiene */
+	signal_sem(su_turno);
+	lock(mutex);
+	signal_sem(su_turno);
+}
+
+static int total_cambios(struct estadisticas *est){
+	int i, total=0;
+
+	for (i=0; i<NUM_MOTIVOS_CAMBIO; i++)
+		total+=est->cambios[i];
+	return total;
+}
+
+static void medir(const struct pagina_info *pag, int modo, char *nombre_modo){
+	struct estadisticas antes, despues;
+	unsigned long long inicio, fin;
+	int desc, ping, pong, pid, i, ticks, cambios;
+
+	if ((desc=crear_mutex("pingpong", NO_RECURSIVO))<0) {
+		printf("error creando pingpong. NO DEBE APARECER\n");
+		return;
+	}
+	if (fijar_modo_mutex(desc, modo)<0)
+		printf("error fijando el modo. NO DEBE APARECER\n");
+	if ((ping=crear_sem("ping", 0))<0)
+		printf("error creando ping. NO DEBE APARECER\n");
+	if ((pong=crear_sem("pong", 0))<0)
+		printf("error creando pong. NO DEBE APARECER\n");
+
+	lock(desc);
+	if ((pid=crear_proceso("rebote"))<0)
+		printf("Error creando rebote\n");
+
+	obtener_estadisticas(&antes);
+	inicio=leer_ticks(pag);
+	for (i=0; i<ITERACIONES; i++)
+		pasar(desc, ping, pong);
+	fin=leer_ticks(pag);
+	obtener_estadisticas(&despues);
+
+	unlock(desc);
+	esperar_proceso(pid, NULL, NULL);
+
+	ticks=fin-inicio;
+	cambios=total_cambios(&despues)-total_cambios(&antes);
+	printf("%s: %d pasadas en %d ticks, %d us y %d.%d%d cambios por pasada"
+		" (%d en el mutex)\n",
+		nombre_modo, ITERACIONES, ticks,
+		ticks*(1000000/pag->ticks_por_seg)/ITERACIONES,
+		cambios/ITERACIONES, cambios*10/ITERACIONES%10,
+		cambios*100/ITERACIONES%10,
+		despues.cambios[CAMBIO_MUTEX]-antes.cambios[CAMBIO_MUTEX]);
+
+	cerrar_sem(ping);
+	cerrar_sem(pong);
+	cerrar_mutex(desc);
+}
+
+int main(){
+	const struct pagina_info *pag;
+
+	printf("prueba_pingpong comienza\n");
+
+	if ((pag=obtener_pagina_info())==NULL) {
+		printf("error obteniendo la pagina de informacion. NO DEBE APARECER\n");
+		return 1;
+	}
+	medir(pag, MODO_COMPETENCIA, "competencia");
+	medir(pag, MODO_CESION, "cesion");
+
+	printf("prueba_pingpong termina\n");
+	return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * usuario/prueba_rw.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los cerrojos de
+ * lectores/escritores. Actua como escritor frente a dos procesos
+ * lector_rw.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int rw, rw2;
+
+	printf("prueba_rw comienza\n");
+
+	if ((rw=crear_rw("conf", RW_PREF_ESCRITORES))<0)
+		printf("error creando conf. NO DEBE APARECER\n");
+
+	if (crear_rw("conf2", 7)<0)
+		printf("error creando conf2 con tipo erroneo. DEBE APARECER\n");
+
+	if (lock_escritura(rw)<0)
+		printf("error en lock_escritura. NO DEBE APARECER\n");
+
+	/* segundo lock del mismo escritor -> error */
+	if (lock_lectura(rw)<0)
+		printf("lock_lectura teniendo el cerrojo como escritor. DEBE APARECER\n");
+
+	if (crear_proceso("lector_rw")<0)
+		printf("Error creando lector_rw\n");
+
+	if (crear_proceso("lector_rw")<0)
+		printf("Error creando lector_rw\n");
+
+	printf("prueba_rw duerme 1 seg.: los lectores se bloquearan en conf\n");
+	dormir(1);
+
+	/* Debe conceder el cerrojo a los dos lectores a la vez */
+	if (unlock_rw(rw)<0)
+		printf("error en unlock_rw. NO DEBE APARECER\n");
+
+	printf("prueba_rw pide escritura: debe esperar a que terminen ambos lectores\n");
+	if (lock_escritura(rw)<0)
+		printf("error en lock_escritura. NO DEBE APARECER\n");
+
+	printf("prueba_rw escribe en exclusiva\n");
+
+	if (unlock_rw(rw)<0)
+		printf("error en unlock_rw. NO DEBE APARECER\n");
+
+	/* sin tener el cerrojo concedido -> error */
+	if (unlock_rw(rw)<0)
+		printf("unlock_rw sin tener el cerrojo. DEBE APARECER\n");
+
+	/* una lectura que no se libera se suelta al cerrar el descriptor */
+	if ((rw2=abrir_rw("conf"))<0)
+		printf("error abriendo conf. NO DEBE APARECER\n");
+	if (lock_lectura(rw2)<0)
+		printf("error en lock_lectura. NO DEBE APARECER\n");
+	if (cerrar_rw(rw2)<0)
+		printf("error cerrando conf. NO DEBE APARECER\n");
+
+	printf("prueba_rw pide escritura: no debe quedarse bloqueado\n");
+	if (lock_escritura(rw)<0)
+		printf("error en lock_escritura. NO DEBE APARECER\n");
+	if (unlock_rw(rw)<0)
+		printf("error en unlock_rw. NO DEBE APARECER\n");
+
+	printf("prueba_rw termina\n");
+	return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * usuario/prueba_sem.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los semaforos. Actua
+ * como productor del proceso consumidor.
+ */
+
+#include "servicios.h"
+
+#define NUM_ELEMENTOS 3
+
+int main(){
+	int huecos, datos, i;
+
+	printf("prueba_sem comienza\n");
+
+	if ((huecos=crear_sem("huecos", 1))<0)
+		printf("error creando huecos. NO DEBE APARECER\n");
+
+	if ((datos=crear_sem("datos", 0))<0)
+		printf("error creando datos. NO DEBE APARECER\n");
+
+	if (crear_sem("datos", 0)<0)
+		printf("error creando datos por segunda vez. DEBE APARECER\n");
+
+	if (crear_proceso("consumidor")<0)
+		printf("Error creando consumidor\n");
+
+	for (i=1; i<=NUM_ELEMENTOS; i++) {
+		if (wait_sem(huecos)<0)
+			printf("error en wait_sem. NO DEBE APARECER\n");
+
+		printf("prueba_sem produce el elemento %d\n", i);
+
+		/* debe despertar directamente al consumidor si esta esperando */
+		if (signal_sem(datos)<0)
+			printf("error en signal_sem. NO DEBE APARECER\n");
+	}
+
+	printf("prueba_sem termina\n");
+
+	/* cierre implicito de semaforos */
+	return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * usuario/prueba_trylock.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de trylock y lock_timeout.
+ * Retiene el mutex "ocupado" mientras impaciente intenta tomarlo.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc, pid;
+
+	printf("prueba_trylock comienza\n");
+
+	if ((desc=crear_mutex("ocupado", NO_RECURSIVO))<0)
+		printf("error creando ocupado. NO DEBE APARECER\n");
+
+	if (trylock(desc)<0)
+		printf("error en trylock con el mutex libre. NO DEBE APARECER\n");
+
+	if ((pid=crear_proceso("impaciente"))<0)
+		printf("Error creando impaciente\n");
+
+	printf("prueba_trylock retiene el mutex 2 segundos\n");
+	dormir(2);
+	unlock(desc);
+
+	esperar_proceso(pid, NULL, NULL);
+	printf("prueba_trylock termina\n");
+	return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * usuario/ps.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que muestra la tabla de procesos usando
+ * listar_procesos. Crea antes un dormilon para que haya algun proceso
+ * bloqueado.
+ */
+
+#include "servicios.h"
+
+#define MAX_ENTRADAS 16
+#define MAX_DESCRIPTORES 128
+
+static char *nombre_estado(int estado){
+	switch (estado) {
+	case LISTO: return "LISTO";
+	case BLOQUEADO: return "BLOQ";
+	case ZOMBI: return "ZOMBI";
+	}
+	return "?";
+}
+
+static char *nombre_objeto(int tipo){
+	switch (tipo) {
+	case OBJ_MUTEX: return "mutex";
+	case OBJ_SEM: return "sem";
+	case OBJ_COND: return "cond";
+	case OBJ_RW: return "rw";
+	case OBJ_MEM: return "mem";
+	case OBJ_COLA: return "cola";
+	}
+	return "?";
+}
+
+static char *nombre_bloqueo(int bloqueo){
+	switch (bloqueo) {
+	case BLOQ_DORMIR: return "dormir";
+	case BLOQ_CREAR_MUTEX: return "crear_mutex";
+	case BLOQ_LOCK: return "lock";
+	case BLOQ_SEM: return "semaforo";
+	case BLOQ_COND: return "condicion";
+	case BLOQ_RW: return "cerrojo_rw";
+	case BLOQ_COLA_ENVIAR: return "enviar";
+	case BLOQ_COLA_RECIBIR: return "recibir";
+	case BLOQ_ESPERA: return "esperar";
+	}
+	return "-";
+}
+
+int main(){
+	struct info_proceso tabla[MAX_ENTRADAS];
+	struct info_descriptor descs[MAX_DESCRIPTORES];
+	struct info_descriptor *desc;
+	int i, d, n;
+
+	if (crear_proceso("dormilon")<0)
+		printf("Error creando dormilon\n");
+	dormir(1);
+
+	if ((n=listar_procesos(tabla, MAX_ENTRADAS, descs,
+			MAX_DESCRIPTORES))<0) {
+		printf("error en listar_procesos. NO DEBE APARECER\n");
+		return 1;
+	}
+
+	printf("ID PADRE ESTADO USU SIS DORMIR PAG/RES ESPERA DESCRIPTORES\n");
+	for (i=0; i<n; i++) {
+		printf("%d %d %s %d %d %d %d/%d %s",
+			tabla[i].id, tabla[i].padre,
+			nombre_estado(tabla[i].estado),
+			tabla[i].usuario, tabla[i].sistema, tabla[i].dormir,
+			tabla[i].paginas, tabla[i].residentes,
+			nombre_bloqueo(tabla[i].bloqueo));
+		if (tabla[i].objeto>=0)
+			printf("(%d)", tabla[i].objeto);
+		for (d=0; d<tabla[i].num_desc; d++) {
+			desc=&descs[tabla[i].primer_desc+d];
+			printf(" %s:%d", nombre_objeto(desc->tipo), desc->desc);
+		}
+		printf("%s\n", tabla[i].es_hilo ? " [hilo]" : "");
+	}
+	return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * usuario/rebote.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de los modos de
+ * entrega de mutex: se turna con prueba_pingpong, mediante los semaforos
+ * "ping" y "pong", para pasarse "pingpong" ITERACIONES veces.
+ */
+
+#include "servicios.h"
+
+#define ITERACIONES 10000
+
+/* igual que en prueba_pingpong, con los turnos cambiados */
+static void pasar(int mutex, int mi_turno, int su_turno){
+	wait_sem(mi_turno);
+	unlock(mutex);
+	wait_sem(mi_turno);
+	signal_sem(su_turno);
+	lock(mutex);
+	signal_sem(su_turno);
+}
+
+int main(){
+	int desc, ping, pong, i;
+
+	if ((desc=abrir_mutex("pingpong"))<0) {
+		printf("error abriendo pingpong. NO DEBE APARECER\n");
+		return 1;
+	}
+	if ((ping=abrir_sem("ping"))<0 || (pong=abrir_sem("pong"))<0) {
+		printf("error abriendo ping o pong. NO DEBE APARECER\n");
+		return 1;
+	}
+
+	/* avisa de que va a pedir el mutex y de que ya lo tiene */
+	signal_sem(ping);
+	lock(desc);
+	signal_sem(ping);
+
+	for (i=0; i<ITERACIONES; i++)
+		pasar(desc, pong, ping);
+
+	/* prueba_pingpong lo suelta al acabar sin esperar turno */
+	unlock(desc);
+	return 0;
+}
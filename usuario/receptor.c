@@ -0,0 +1,41 @@
+/*
+ * usuario/receptor.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de las colas de
+ * mensajes
+ */
+
+#include "servicios.h"
+
+#define NUM_MENSAJES 4
+
+int main(){
+	int cola, i, longitud;
+	char buf[16];
+
+	printf("receptor comienza\n");
+
+	if ((cola=abrir_cola("tuberia"))<0)
+		printf("error abriendo tuberia. NO DEBE APARECER\n");
+
+	for (i=0; i<NUM_MENSAJES; i++) {
+		if ((longitud=recibir(cola, buf, sizeof(buf)))<0)
+			printf("error en recibir. NO DEBE APARECER\n");
+		else
+			printf("receptor recibe %s (%d bytes)\n", buf, longitud);
+	}
+
+	/* cola vacia: el envio no bloqueante si debe funcionar */
+	if (enviar_nb(cola, "z", 2)<0)
+		printf("error en enviar_nb. NO DEBE APARECER\n");
+
+	printf("receptor termina\n");
+	return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * usuario/saliente.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que termina con un estado de salida concreto.
+ * Lo usa prueba_espera.
+ */
+
+#include "servicios.h"
+
+#define ESTADO 7
+
+int main(){
+	int i;
+
+	for (i=0; i<20; i++)
+		printf("saliente: i %d\n", i);
+
+	printf("saliente: termina con estado %d\n", ESTADO);
+	salir(ESTADO);
+
+	/* No debera llegar */
+	printf("saliente: sigue tras salir. NO DEBE APARECER\n");
+	return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * usuario/visor_mem.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ *  Fernando Prez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de la memoria
+ * compartida
+ */
+
+#include "servicios.h"
+
+int main(){
+	char *region;
+	int listo;
+
+	printf("visor_mem comienza\n");
+
+	if ((region=abrir_memoria_compartida("reg"))==NULL)
+		printf("error abriendo reg. NO DEBE APARECER\n");
+
+	if ((listo=abrir_sem("listo"))<0)
+		printf("error abriendo listo. NO DEBE APARECER\n");
+
+	wait_sem(listo);
+	printf("visor_mem lee en reg: %s\n", region);
+
+	printf("visor_mem termina\n");
+
+	/* cierre implicito: se libera reg al no quedar procesos */
+	return 0;
+}